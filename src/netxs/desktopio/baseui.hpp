@@ -635,6 +635,7 @@ namespace netxs::ui
         bind atgrow; // base: Bindings on enlarging.
         bind atcrop; // base: Bindings on shrinking.
         bool wasted; // base: Should the object be redrawn. //todo make it rect{}
+        rect damage; // base: Local area to redraw if the object is not wasted (see base::retouch).
         bool hidden; // base: Ignore rendering and resizing.
         bool locked; // base: Object has fixed size.
         bool master; // base: Anycast root.
@@ -667,8 +668,9 @@ namespace netxs::ui
         void   kind(si32 k) { family = k;                  }
         auto center() const { return region.center();      }
         auto parent()       { return father.lock();        }
-        void ruined(bool s) { wasted = s;                  }
-        auto ruined() const { return wasted;               }
+        void ruined(bool s) { wasted = s; damage = {}; if (s) bell::indexer.quartz.wake(); }
+        auto ruined() const { return wasted || !!damage;   }
+        auto damaged() const { return wasted ? rect{ dot_00, region.size } : damage; }
         // base: Return sptr of the object by its id.
         template<class T = base>
         auto getref(id_t id)
@@ -961,6 +963,7 @@ namespace netxs::ui
                 parent_ptr = next_parent_ptr;
                 parent_ptr->base::wasted = true; //todo parent_ptr->base::wasted = area;
             }
+            bell::indexer.quartz.wake(); // Request the next frame.
         }
         // base: Mark the visual subtree as requiring redrawing.
         void strike()
@@ -978,6 +981,21 @@ namespace netxs::ui
         {
             base::deface(base::region);
         }
+        // base: Mark the local area of the form as requiring redrawing. Ancestors caching their bitmaps redraw only this area.
+        void retouch(rect area)
+        {
+            auto parent_ptr = This();
+            while (true)
+            {
+                auto& scar = parent_ptr->base::damage;
+                if (!parent_ptr->base::wasted) scar = scar ? scar | area : area;
+                auto next_parent_ptr = parent_ptr->base::parent();
+                if (!next_parent_ptr) break;
+                area.coor += parent_ptr->base::region.coor + parent_ptr->base::intpad.corner();
+                parent_ptr = next_parent_ptr;
+            }
+            bell::indexer.quartz.wake(); // Request the next frame.
+        }
         // base: Going to rebuild visual tree. Retest current size, ask parent if it is linked.
         template<bool Forced = faux>
         void reflow()
@@ -1409,6 +1427,7 @@ namespace netxs::ui
                 boss.LISTEN(tier::general, e2::timer::any, p, memo[ID], (ID, proc, flow, init))
                 {
                     auto now = datetime::round<si32>(p - init);
+                    boss.bell::indexer.quartz.wake(); // Keep ticking at the frame rate while animating.
                     if (auto data = flow(now))
                     {
                         static constexpr auto zero = std::decay_t<decltype(data.value())>{};
@@ -1489,6 +1508,7 @@ namespace netxs::ui
                         alarm = now + timeout;
                         if (!lambda(ID)) pacify(ID);
                     }
+                    boss.bell::indexer.quartz.expect(alarm);
                 };
             }
             // pro::timer: Start countdown.
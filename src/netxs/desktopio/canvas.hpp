@@ -968,69 +968,157 @@ namespace netxs
         }
     };
 
+    // canvas: Divide the boxblur row sums by the count using SIMD (sums are non-negative).
+    void boxblur_quot(irgb<si32> const* accum, irgb<si32>* quot, si32 w, si32 count)
+    {
+        static_assert(sizeof(irgb<si32>) == 16);
+        auto head = (si32 const*)accum;
+        auto dest = (si32*)quot;
+        auto size = w * 4;
+        auto iter = 0;
+        if (count < 1 << 15) // Quotients of sums below 2^23 are exact in fp32 after the remainder correction.
+        {
+            #if defined(__AVX2__)
+            auto d = _mm256_set1_ps((fp32)count);
+            auto n = _mm256_set1_ps(1.f / count);
+            auto one = _mm256_set1_ps(1.f);
+            while (size - iter >= 8)
+            {
+                auto a = _mm256_cvtepi32_ps(_mm256_loadu_si256((__m256i const*)(head + iter)));
+                auto q = _mm256_round_ps(_mm256_mul_ps(a, n), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+                auto m = _mm256_sub_ps(a, _mm256_mul_ps(q, d));
+                q = _mm256_sub_ps(q, _mm256_and_ps(_mm256_cmp_ps(m, _mm256_setzero_ps(), _CMP_LT_OQ), one));
+                q = _mm256_add_ps(q, _mm256_and_ps(_mm256_cmp_ps(m, d, _CMP_GE_OQ), one));
+                _mm256_storeu_si256((__m256i*)(dest + iter), _mm256_cvttps_epi32(q));
+                iter += 8;
+            }
+            #elif defined(NETXS_SSE2)
+            auto d = _mm_set1_ps((fp32)count);
+            auto n = _mm_set1_ps(1.f / count);
+            auto one = _mm_set1_ps(1.f);
+            while (size - iter >= 4)
+            {
+                auto a = _mm_cvtepi32_ps(_mm_loadu_si128((__m128i const*)(head + iter)));
+                auto q = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(a, n)));
+                auto m = _mm_sub_ps(a, _mm_mul_ps(q, d));
+                q = _mm_sub_ps(q, _mm_and_ps(_mm_cmplt_ps(m, _mm_setzero_ps()), one));
+                q = _mm_add_ps(q, _mm_and_ps(_mm_cmpge_ps(m, d), one));
+                _mm_storeu_si128((__m128i*)(dest + iter), _mm_cvttps_epi32(q));
+                iter += 4;
+            }
+            #endif
+        }
+        while (iter < size)
+        {
+            dest[iter] = head[iter] / count;
+            iter++;
+        }
+    }
+
     // canvas: Grapheme cluster.
     struct cell
     {
         struct glyf
         {
-            static auto jumbos()
+            static auto& jumbos()
             {
-                using lock = std::mutex;
-                using sync = std::lock_guard<lock>;
+                using lock = std::shared_mutex;
                 using depo = std::unordered_map<ui64, text>;
                 using uset = std::unordered_set<ui64>;
 
+                // Clusters are never erased or overwritten: cells keep only the token, so the text must stay available,
+                // and the element references remain stable (std::unordered_map nodes are not relocated).
+                static constexpr auto count = 16; // Number of the independently locked shards.
+                static constexpr auto ahead = 64; // Number of the per-thread cached lookups.
+
                 struct vars
                 {
-                    lock mutex{}; // Cluster map mutex. Do we need to reset/clear/flush the map?
-                    depo jumbo{}; // Jumbo cluster map.
-                    uset undef{}; // List of unknown tokens.
-                };
-                struct guard : sync
-                {
-                    depo& map;
-                    uset& unk;
-                    guard(vars& inst)
-                        : sync{ inst.mutex },
-                           map{ inst.jumbo },
-                           unk{ inst.undef }
-                    { }
+                    struct shard
+                    {
+                        lock mutex{}; // shard: Cluster map mutex.
+                        depo jumbo{}; // shard: Jumbo cluster map.
+                    };
+                    using memo = std::array<std::pair<ui64, text const*>, ahead>;
+
+                    shard      parts[count]; // Cluster map shards.
+                    std::mutex undef_mutex{}; // List of unknown tokens mutex.
+                    uset       undef{}; // List of unknown tokens.
+
+                    static auto index(ui64 token)
+                    {
+                        return (sz_t)((token >> 8 * 2) ^ (token >> 8 * 5)); // Skip the metadata and the jumbo mark bytes.
+                    }
+                    auto& part(ui64 token)
+                    {
+                        return parts[index(token) % count];
+                    }
+                    // jumbos: Lookup the cluster, first in the lock-free per-thread cache.
+                    text const* find(ui64 token)
+                    {
+                        thread_local auto cache = memo{};
+                        auto& [cached_token, cached_ptr] = cache[index(token) % ahead];
+                        if (cached_ptr && cached_token == token) return cached_ptr;
+                        auto& p = part(token);
+                        auto guard = std::shared_lock{ p.mutex };
+                        if (auto iter = p.jumbo.find(token); iter != p.jumbo.end())
+                        {
+                            cached_token = token;
+                            cached_ptr = &iter->second;
+                            return cached_ptr;
+                        }
+                        return nullptr;
+                    }
+                    void unknown(ui64 token)
+                    {
+                        auto guard = std::lock_guard{ undef_mutex };
+                        undef.insert(token);
+                    }
                     // jumbos: Get cluster.
-                    auto& get(ui64 token)
+                    text const& get(ui64 token)
                     {
-                        if (auto iter = map.find(token); iter != map.end())
+                        if (auto cluster_ptr = find(token))
                         {
-                            return iter->second;
+                            return *cluster_ptr;
                         }
                         else
                         {
                             static auto empty = text{};
-                            unk.insert(token);
+                            unknown(token);
                             return empty;
                         }
                     }
-                    // jumbos: Set cluster.
+                    // jumbos: Set cluster. Stored clusters are immutable (readers hold them without the lock), so the existing one is kept.
                     void set(ui64 token, view data)
                     {
-                        map[token] = data;
+                        auto& p = part(token);
+                        auto guard = std::unique_lock{ p.mutex };
+                        p.jumbo.try_emplace(token, data);
                     }
                     // jumbos: Add cluster.
                     void add(ui64 token, view data)
                     {
-                        map.insert(std::pair{ token, data }); // Silently ignore if it exists.
+                        if (find(token)) return; // Silently ignore if it exists.
+                        auto& p = part(token);
+                        auto guard = std::unique_lock{ p.mutex };
+                        p.jumbo.try_emplace(token, data);
                     }
                     // jumbos: Check the cluster existence by token.
                     auto exists(ui64 token)
                     {
-                        auto iter = map.find(token);
-                        auto okay = iter != map.end();
-                        if (!okay) unk.insert(token);
+                        auto okay = !!find(token);
+                        if (!okay) unknown(token);
                         return okay;
                     }
+                    // jumbos: Take the list of unknown tokens.
+                    auto unk()
+                    {
+                        auto guard = std::lock_guard{ undef_mutex };
+                        return std::exchange(undef, uset{});
+                    }
                 };
 
                 static auto inst = vars{};
-                return guard{ inst };
+                return inst;
             }
 
             // If bytes[1] & 0b11'00'0000 == 0b10'00'0000 (first byte in UTF-8 cannot start with 0b10......) - If so, cluster is stored in an external map (jumbo cluster).
@@ -2479,6 +2567,54 @@ namespace netxs
         }
     };
 
+    // canvas: Return the offset of the first cell that differs in the cell::operator== sense (the link ID is ignored). Return the length of the shortest span if there are no differences.
+    auto mismatch(std::span<cell const> a, std::span<cell const> b)
+    {
+        static_assert(sizeof(cell) == 32 && offsetof(cell, id) == 24 && sizeof(cell::id) == 4); // Cell layout: uv(8) gc(8) st(8) id(4) px(4).
+        auto size = std::min(a.size(), b.size());
+        auto head = (byte const*)a.data();
+        auto dest = (byte const*)b.data();
+        auto iter = size_t{ 0 };
+        #if defined(__AVX2__)
+            static constexpr auto id_mask = (si32)0x0F00'0000; // Ignore id bytes 24-27.
+            auto test = [&](auto offset)
+            {
+                return _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i const*)(head + offset)),
+                                         _mm256_loadu_si256((__m256i const*)(dest + offset)));
+            };
+            while (iter + 4 <= size) // Four cells at a time.
+            {
+                auto offset = iter * sizeof(cell);
+                auto m = _mm256_and_si256(_mm256_and_si256(test(offset +  0), test(offset + 32)),
+                                          _mm256_and_si256(test(offset + 64), test(offset + 96)));
+                if ((_mm256_movemask_epi8(m) | id_mask) != -1) break; // Locate the cell below.
+                iter += 4;
+            }
+            while (iter < size && (_mm256_movemask_epi8(test(iter * sizeof(cell))) | id_mask) == -1) iter++;
+        #elif defined(NETXS_SSE2)
+            auto test = [&](auto offset) // Ignore id bytes 24-27 (bytes 8-11 of the upper half).
+            {
+                auto lo = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const*)(head + offset +  0)), _mm_loadu_si128((__m128i const*)(dest + offset +  0)));
+                auto hi = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const*)(head + offset + 16)), _mm_loadu_si128((__m128i const*)(dest + offset + 16)));
+                return _mm_and_si128(lo, _mm_or_si128(hi, _mm_set_epi32(0, -1, 0, 0)));
+            };
+            while (iter + 2 <= size) // Two cells at a time.
+            {
+                auto offset = iter * sizeof(cell);
+                if (_mm_movemask_epi8(_mm_and_si128(test(offset), test(offset + 32))) != 0xFFFF) break; // Locate the cell below.
+                iter += 2;
+            }
+            while (iter < size && _mm_movemask_epi8(test(iter * sizeof(cell))) == 0xFFFF) iter++;
+        #else
+            auto a_ptr = a.data();
+            auto b_ptr = b.data();
+            while (iter < size && a_ptr[iter] == b_ptr[iter]) iter++;
+            (void)head;
+            (void)dest;
+        #endif
+        return iter;
+    }
+
     enum class bias : byte { none, left, right, center, };
     enum class wrap : byte { none, on,  off,            };
     enum class rtol : byte { none, rtl, ltr,            };
@@ -2771,6 +2907,7 @@ namespace netxs
     public:
         using span = std::span<cell const>;
         using body = std::vector<cell>;
+        using rows = std::vector<twod>;
 
     protected:
         si32 digest = 0; // core: Resize stamp.
@@ -2778,6 +2915,7 @@ namespace netxs
         rect client; // core: Active canvas area relative to current basis.
         body canvas; // core: Cell data.
         cell marker; // core: Current brush.
+        rows damage; // core: Dirty span journal. One [x, y) column range per row. Empty if the journal is not tracked.
 
     public:
         core()                         = default;
@@ -2944,6 +3082,98 @@ namespace netxs
             each([&](cell& c){ c.scan(crop); });
             return crop;
         }
+        auto& dirty() const // core: Return the dirty span journal.
+        {
+            return damage;
+        }
+        void taint() // core: Drop the dirty span journal (the next sync will make a full copy).
+        {
+            damage.clear();
+        }
+        static auto merge(rows& dst, rows const& src) // core: Unite two dirty span journals. Return faux if they have different heights.
+        {
+            if (dst.empty())
+            {
+                dst = src;
+                return true;
+            }
+            if (dst.size() != src.size()) return faux;
+            auto iter = src.begin();
+            for (auto& band : dst)
+            {
+                auto& next = *iter++;
+                if (next.x < next.y)
+                {
+                    band = band.x < band.y ? twod{ std::min(band.x, next.x), std::max(band.y, next.y) }
+                                           : next;
+                }
+            }
+            return true;
+        }
+        void taint(rows const& bands) // core: Extend the dirty span journal by the specified spans.
+        {
+            if (bands.empty()) return;
+            if (damage.empty() || !merge(damage, bands)) damage.clear();
+        }
+        void sync(core const& src) // core: Copy only the changed cells of the src and extend the dirty span journal.
+        {
+            region.coor = src.region.coor;
+            client = src.client;
+            marker = src.marker;
+            if (region.size != src.region.size || digest != src.digest || damage.size() != (size_t)region.size.y)
+            {
+                region.size = src.region.size;
+                digest = src.digest;
+                canvas = src.canvas;
+                damage.assign(region.size.y, twod{ 0, region.size.x });
+                return;
+            }
+            auto w = region.size.x;
+            auto same = [](cell const& a, cell const& b){ return a == b && a.link() == b.link(); };
+            auto dst = canvas.begin();
+            auto src_ptr = src.canvas.begin();
+            for (auto& band : damage)
+            {
+                auto head = src_ptr;
+                auto tail = src_ptr + w;
+                if (w && std::memcmp(&*head, &*dst, w * sizeof(cell))) // The cell layout has no padding.
+                {
+                    auto [new_head, dst_head] = std::mismatch(head, tail, dst, same);
+                    auto dst_tail = dst + w;
+                    while (same(*(tail - 1), *(dst_tail - 1))) // Stops at new_head at most.
+                    {
+                        --tail;
+                        --dst_tail;
+                    }
+                    std::copy(new_head, tail, dst_head);
+                    auto x1 = (si32)(new_head - src_ptr);
+                    auto x2 = (si32)(tail - src_ptr);
+                    band = band.x < band.y ? twod{ std::min(band.x, x1), std::max(band.y, x2) }
+                                           : twod{ x1, x2 };
+                }
+                src_ptr += w;
+                dst += w;
+            }
+        }
+        void flush(core& src) // core: Copy the journaled spans of the same-sized src and mark the src journal clean.
+        {
+            assert(region.size == src.region.size && src.damage.size() == (size_t)region.size.y);
+            auto w = region.size.x;
+            auto dst = canvas.begin();
+            auto src_ptr = src.canvas.begin();
+            for (auto& band : src.damage)
+            {
+                if (band.x < band.y)
+                {
+                    std::copy(src_ptr + band.x, src_ptr + band.y, dst + band.x);
+                    band = dot_00;
+                }
+                src_ptr += w;
+                dst += w;
+            }
+            digest = src.digest;
+            marker = src.marker;
+        }
         auto copy(body& target) const // core: Copy only body of the canvas to the specified body bitmap.
         {
             target = canvas;
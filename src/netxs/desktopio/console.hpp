@@ -68,6 +68,14 @@ namespace netxs::ui
             isbusy.exchange(faux);
         }
         virtual bool send(view buff) = 0;
+        virtual bool send(std::span<view const> list) // Send blocks in order without concatenating them if the channel allows.
+        {
+            for (auto block : list)
+            {
+                if (block.size() && !send(block)) return faux;
+            }
+            return true;
+        }
         virtual qiew recv(char* buff, size_t size) = 0;
         virtual qiew recv() = 0;
         virtual bool shut()
@@ -123,8 +131,9 @@ namespace netxs::ui
             template<class E, class T>
             void notify(E, T&& data, si32 Tier = tier::release)
             {
-                owner.base::enqueue([Tier, d = data](auto& boss) mutable
+                owner.base::enqueue([Tier, d = data, stamp = datetime::now()](auto& boss) mutable
                 {
+                    static_cast<gate&>(boss).stall.add(datetime::now() - stamp);
                     boss.base::signal(Tier, E::id, d);
                 });
             }
@@ -212,7 +221,7 @@ namespace netxs::ui
                 auto& items = lock.thing;
                 auto list = s11n::jgc_list.freeze();
                 {
-                    auto jumbos = cell::glyf::jumbos();
+                    auto& jumbos = cell::glyf::jumbos();
                     for (auto& gc : items)
                     {
                         auto& cluster = jumbos.get(gc.token);
@@ -248,48 +257,124 @@ namespace netxs::ui
         struct diff
         {
             using work = std::thread;
-            using lock = std::mutex;
-            using cond = std::condition_variable_any;
+            using slot = std::atomic<si32>;
+            using tick = std::atomic<sz_t>;
+            using hist = generics::hist;
+            using lags = std::atomic<span>;
+            using mark = std::atomic<time>;
 
             struct stat
             {
                 span watch{}; // diff::stat: Rendering duration.
                 sz_t delta{}; // diff::stat: Last rendered frame size.
+                sz_t drops{}; // diff::stat: Number of frames discarded in the middle of rendering (see diff::cancel).
+                sz_t joins{}; // diff::stat: Number of frames superseded by a newer one before being rendered.
             };
 
+            static constexpr auto fresh = si32{ 1 << 2 }; // diff: Mark of the unrendered frame in the middle buffer index.
+            static constexpr auto tight = span{ 50ms }; // diff: Frame delivery time above which the link is considered congested.
+            static constexpr auto loose = span{ 15ms }; // diff: Frame delivery time below which the link is considered clear.
+            static constexpr auto quiet = span{ 500ms }; // diff: Idle period after which the congestion is forgotten.
+
             pipe& canal; // diff: Channel to outside.
-            lock  mutex; // diff: Mutex between renderer and committer threads.
-            cond  synch; // diff: Synchronization between renderer and committer.
-            core  cache; // diff: The current content buffer which going to be checked and processed.
+            core  queue[3]; // diff: Triple buffer: back (committer side), middle (shared), front (renderer side).
+            slot  ready; // diff: Middle buffer index combined with the fresh mark.
+            si32  owner; // diff: Back buffer index.
             flag  alive; // diff: Working loop state.
-            flag  ready; // diff: Conditional variable to avoid spurious wakeup.
             flag  abort; // diff: Abort building current frame.
+            tick  drops; // diff: Aborted frame counter.
+            tick  joins; // diff: Coalesced frame counter.
             work  paint; // diff: Rendering thread.
             stat  debug; // diff: Debug info.
+            hist  spent; // diff: Frame diff duration histogram (ns).
+            hist  sizes; // diff: Sent frame size histogram (bytes).
+            lags  delay; // diff: Smoothed frame delivery time.
+            tick  speed; // diff: Smoothed link throughput (bytes per second).
+            mark  lastly; // diff: Last frame delivery timestamp.
+            flag  cheap; // diff: The coarse encoding is in use.
 
-            // diff: Render current buffer.
-            template<class Bitmap>
+            // diff: Update the link estimates using the last delivered frame.
+            void gauge(sz_t bytes, span lag)
+            {
+                auto prior = delay.load();
+                delay = lag > prior ? (prior + lag) / 2 // Rise fast, fall slow.
+                                    : (prior * 3 + lag) / 4;
+                auto nanos = std::max<ui64>(1, datetime::round<ui64, std::chrono::nanoseconds>(lag));
+                auto value = (sz_t)std::min<ui64>(bytes * 1'000'000'000ull / nanos, std::numeric_limits<sz_t>::max());
+                speed = (sz_t)(((ui64)speed.load() * 3 + value) / 4);
+                lastly = datetime::now();
+            }
+            // diff: Render the latest committed buffer. Switch to the Coarse encoding while the link is congested.
+            template<class Bitmap, class Coarse = Bitmap>
             void render()
             {
                 if constexpr (debugmode) log(prompt::diff, "Rendering thread started", ' ', utf::to_hex_0x(std::this_thread::get_id()));
                 auto start = time{};
                 auto image = Bitmap{};
-                auto guard = std::unique_lock{ mutex };
-                while ((void)synch.wait(guard, [&]{ return !!ready; }), alive)
+                auto lower = Coarse{};
+                auto reset = faux; // The encoder has just taken over the output and does not know the terminal state.
+                auto front = si32{ 2 };
+                auto bands = core::rows{};
+                core::rows stale[3]; // Spans of the reference image changed since the buffer was last rendered.
+                bool whole[3] = {}; // The reference image has been replaced since the buffer was last rendered.
+                while (alive)
                 {
-                    start = datetime::now();
-                    ready = faux;
+                    auto state = ready.load();
+                    if (!(state & fresh))
+                    {
+                        ready.wait(state);
+                        continue;
+                    }
                     abort = faux;
+                    front = ready.exchange(front) & ~fresh; // Take the latest frame and return the previous one to the committer.
+                    start = datetime::now();
+                    auto& cache = queue[front];
+                    if (whole[front]) cache.taint();
+                    else              cache.taint(stale[front]);
+                    whole[front] = faux;
+                    stale[front].clear();
+                    bands = cache.dirty(); // The reference image is going to be updated within these spans.
+                    if constexpr (!std::is_same_v<Bitmap, Coarse>)
+                    {
+                        auto value = delay.load();
+                        if (cheap ? value < loose : value > tight)
+                        {
+                            cheap = !cheap;
+                            reset = true;
+                        }
+                    }
                     auto winid = id_t{ 0xddccbbaa };
                     auto coord = dot_00;
-                    image.set(winid, coord, cache, abort, debug.delta);
+                    auto build = [&](auto& image)
+                    {
+                        if constexpr (!std::is_same_v<Bitmap, Coarse>)
+                        {
+                            if (reset) image.renew();
+                        }
+                        image.set(winid, coord, cache, abort, debug.delta);
+                        if (!abort) reset = faux;
+                    };
+                    if constexpr (std::is_same_v<Bitmap, Coarse>) build(image);
+                    else                                           cheap ? build(lower) : build(image);
+                    if (!abort) spent.add(datetime::now() - start);
+                    auto replaced = cache.dirty().empty(); // The reference image has been swapped out.
+                    if (replaced || !abort)
+                    {
+                        for (auto i = 0; i < 3; i++) if (i != front && !whole[i])
+                        {
+                            whole[i] = replaced || !core::merge(stale[i], bands);
+                        }
+                    }
+                    if (abort) drops++;
                     if (debug.delta)
                     {
-                        guard.unlock(); // Allow to abort.
+                        sizes.add(debug.delta);
                         canal.isbusy = true; // It's okay if someone resets the busy flag before sending.
-                        image.sendby(canal);
-                        canal.isbusy.wait(true); // Successive frames must be discarded until the current frame is delivered (to prevent unlimited buffer growth).
-                        guard.lock();
+                        auto sent = datetime::now();
+                        if constexpr (std::is_same_v<Bitmap, Coarse>) image.sendby(canal);
+                        else                                           cheap ? lower.sendby(canal) : image.sendby(canal);
+                        if (alive) canal.isbusy.wait(true); // Successive frames are coalesced until the current frame is delivered (to prevent unlimited buffer growth).
+                        gauge(debug.delta, datetime::now() - sent);
                     }
                     debug.watch = datetime::now() - start;
                 }
@@ -298,57 +383,66 @@ namespace netxs::ui
             // diff: Get rendering statistics.
             auto status()
             {
-                return debug;
+                auto s = debug;
+                s.drops = drops;
+                s.joins = joins;
+                return s;
+            }
+            // diff: Return the frame interval that the link can sustain.
+            auto pause()
+            {
+                auto value = delay.load();
+                return value < loose ? span::zero() : std::min(value, quiet);
+            }
+            // diff: Forget the link congestion after a quiet period. Return true if the last frame should be resent at full fidelity.
+            auto relax(time stamp)
+            {
+                if (canal.isbusy || delay.load() < loose || stamp - lastly.load() < quiet) return faux;
+                delay = span::zero();
+                return cheap.load();
+            }
+            // diff: Return the time the link congestion is forgotten at.
+            auto relaxed()
+            {
+                return lastly.load() + quiet;
             }
             // diff: Discard current frame.
             void cancel()
             {
                 abort = true;
             }
-            // diff: Try to add the touched canvas image to the queue for analysis and sending detected differences.
+            // diff: Commit the touched canvas image for analysis and sending detected differences. Never blocks: an unrendered frame is replaced by the newer one.
             auto send(core const& canvas)
             {
-                if (abort)
-                {
-                    while (alive) // Try to send a new frame as soon as possible (e.g. after resize).
-                    {
-                        auto lock = std::unique_lock{ mutex, std::try_to_lock };
-                        if (lock.owns_lock())
-                        {
-                            cache = canvas;
-                            ready = true;
-                            synch.notify_one();
-                            return true;
-                        }
-                        else std::this_thread::yield();
-                    }
-                }
-                else
-                {
-                    auto lock = std::unique_lock{ mutex, std::try_to_lock };
-                    if (lock.owns_lock())
-                    {
-                        cache = canvas;
-                        ready = true;
-                        synch.notify_one();
-                        return true;
-                    }
-                }
-                return faux;
+                if (!alive) return faux;
+                auto& back = queue[owner];
+                back.sync(canvas); // Copy only the changed spans.
+                auto prev = ready.exchange(owner | fresh);
+                owner = prev & ~fresh;
+                if (prev & fresh) joins++;
+                ready.notify_one();
+                return true;
             }
 
             diff(pipe& dest, svga vtmode)
                 : canal{ dest },
+                  ready{ 1 },
+                  owner{ 0 },
                   alive{ true },
-                  ready{ faux },
-                  abort{ faux }
+                  abort{ faux },
+                  drops{ 0 },
+                  joins{ 0 },
+                  delay{ span::zero() },
+                  speed{ 0 },
+                  lastly{ time{} },
+                  cheap{ faux }
             {
                 using namespace netxs::directvt;
                 paint = std::thread{ [&, vtmode]
                 {
                          if (vtmode == svga::dtvt ) render<binary::bitmap_dtvt_t >();
                     else if (vtmode == svga::vt_2D) render<binary::bitmap_vt_2D_t>();
-                    else if (vtmode == svga::vtrgb) render<binary::bitmap_vtrgb_t>();
+                    else if (vtmode == svga::vtrgb) render<binary::bitmap_vtrgb_t, binary::bitmap_vt256_t>();
                     else if (vtmode == svga::vt256) render<binary::bitmap_vt256_t>();
                     else if (vtmode == svga::vt16 ) render<binary::bitmap_vt16_t >();
                     else if (vtmode == svga::nt16 ) render<binary::bitmap_dtvt_t >();
@@ -358,19 +452,8 @@ namespace netxs::ui
             {
                 if (!alive.exchange(faux)) return;
                 auto thread_id = paint.get_id();
-                while (true)
-                {
-                    auto guard = std::unique_lock{ mutex, std::try_to_lock };
-                    if (guard.owns_lock())
-                    {
-                        ready = true;
-                        synch.notify_all();
-                        break;
-                    }
-                    canal.isbusy = faux;
-                    canal.isbusy.notify_all();
-                    std::this_thread::yield();
-                }
+                ready.fetch_or(fresh); // Wake up the renderer.
+                ready.notify_all();
                 canal.isbusy = faux;
                 canal.isbusy.notify_all();
                 paint.join();
@@ -478,6 +561,35 @@ namespace netxs::ui
         std::unordered_map<id_t, netxs::sptr<hids>> gears; // gate: .
         pro::debug& debug;
         input::multihome_t& multihome;
+        generics::hist parse; // gate: Input parsing duration histogram (ns).
+        generics::hist scene; // gate: Scene rendering duration histogram (ns).
+        generics::hist stall; // gate: Input event wait for the UI lock histogram (ns).
+        time       paced; // gate: The earliest time of the next frame that the link can sustain.
+
+        // gate: Return the frame timing and throughput statistics as a single JSON line.
+        auto telemetry(bool reset = faux)
+        {
+            auto crop = [&](auto name, auto& h)
+            {
+                auto count = h.count();
+                auto p50 = h.quantile(0.50);
+                auto p99 = h.quantile(0.99);
+                if (reset) h.reset();
+                return utf::concat(",\"", name, "\":{\"n\":", count, ",\"p50\":", p50, ",\"p99\":", p99, "}");
+            };
+            auto s = paint.status();
+            auto line = utf::concat("{\"gate\":", bell::id, ",\"user\":");
+            utf::quote(props.os_user_id, line, '"');
+            line += utf::concat(crop("parse_ns",  parse),
+                                crop("render_ns", scene),
+                                crop("diff_ns",   paint.spent),
+                                crop("bytes",     paint.sizes),
+                                crop("wait_ns",   stall),
+                                ",\"dropped\":", s.drops, ",\"coalesced\":", s.joins,
+                                ",\"lag_ns\":", datetime::round<ui64, std::chrono::nanoseconds>(paint.delay.load()),
+                                ",\"bps\":", paint.speed.load(), ",\"coarse\":", paint.cheap ? 1 : 0, "}");
+            return line;
+        }
 
         void set_fullscreen(bool state)
         {
@@ -650,6 +762,7 @@ namespace netxs::ui
                 auto& gear = *gear_ptr;
                 if (gear.mouse_disabled) continue;
                 result |= gear.tooltip.check(now);
+                if (auto deadline = gear.tooltip.pending()) bell::indexer.quartz.expect(deadline.value());
             }
             return result;
         }
@@ -657,6 +770,7 @@ namespace netxs::ui
         // gate: .
         void rebuild_scene(time stamp)
         {
+            auto start = datetime::now();
             auto damaged = base::ruined();
             if (props.tooltip_enabled)
             {
@@ -664,6 +778,11 @@ namespace netxs::ui
             }
             if (damaged)
             {
+                if (stamp < paced) // Hold the frame until the link catches up (the damage is kept).
+                {
+                    bell::indexer.quartz.expect(paced);
+                    return;
+                }
                 if (auto context2D = canvas.change_basis(base::area()))
                 {
                     canvas.wipe(props.background_color);
@@ -713,16 +832,23 @@ namespace netxs::ui
                     for (auto& [ext_gear_id, gear_ptr] : gears)
                     {
                         auto& gear = *gear_ptr;
-                        if (gear.board::shown && props.clip_preview_time < stamp - gear.delta.stamp())
+                        if (!gear.board::shown) continue;
+                        auto deadline = gear.delta.stamp() + props.clip_preview_time;
+                        if (deadline < stamp)
                         {
                             base::deface();
                             return;
                         }
+                        bell::indexer.quartz.expect(deadline);
                     }
                 }
+                if (paint.relax(stamp)) yield = faux; // Resend the last frame at full fidelity.
+                else if (paint.cheap) bell::indexer.quartz.expect(paint.relaxed()); // Wake up to resend it even if the desktop is idle.
                 if (yield) return;
             }
             yield = paint.send(canvas); // Try to output updated canvas if paint is not busy.
+            paced = stamp + paint.pause();
+            scene.add(datetime::now() - start);
 
             if (props.debug_overlay) // Get rendering stats.
             {
@@ -745,7 +871,12 @@ namespace netxs::ui
         {
             auto root_ptr = This();
             base::signal(tier::anycast, e2::form::upon::started, root_ptr); // Make all stuff ready to receive input.
-            directvt::binary::stream::reading_loop(canal, [&](view data){ conio.s11n::sync(data); });
+            directvt::binary::stream::reading_loop(canal, [&](view data)
+            {
+                auto start = datetime::now();
+                conio.s11n::sync(data);
+                parse.add(datetime::now() - start);
+            });
             conio.s11n::stop(); // Wake up waiting dtvt objects, if any.
             if constexpr (debugmode) log(prompt::gate, "DirectVT session closed");
             base::signal(tier::release, e2::form::upon::stopped, true);
@@ -1168,7 +1168,7 @@ struct impl : consrv
 
             do
             {
-                if (worker.queue.size() > 1) // Do not interfere with other event waiters.
+                if (worker.size() > 1) // Do not interfere with other event waiters.
                 {
                     cooked.ustr.clear();
                     //if (cooked.ustr.empty())
@@ -1506,7 +1506,7 @@ struct impl : consrv
                         }
                     }
                 }
-                if (worker.queue.size() == 1) // Clear the queue if we are the one requester.
+                if (worker.size() == 1) // Clear the queue if we are the one requester.
                 {
                     stream.clear(); // Don't try to catch the next events (we are too fast for IME input; ~1ms between events from IME).
                 }
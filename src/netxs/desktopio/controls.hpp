@@ -154,8 +154,8 @@ namespace netxs::events
     si32 luna::vtmlua_push_value(lua_State* lua, auto&& v)
     {
         using T = std::decay_t<decltype(v)>;
-        static constexpr auto is_string_v = requires{ (const char*)v.data(); };
-        static constexpr auto is_cstring_v = !std::is_same_v<T, twod> && requires{ (const char*)&v[0]; };
+        static constexpr auto is_string_v = requires{ { v.data() } -> std::convertible_to<const char*>; v.size(); };
+        static constexpr auto is_cstring_v = requires{ { &v[0] } -> std::convertible_to<const char*>; };
 
         auto args_count = 1;
              if constexpr (std::is_same_v<T, bool>)                  ::lua_pushboolean(lua, v);
@@ -165,9 +165,9 @@ namespace netxs::events
         else if constexpr (std::is_same_v<T, time>)                  luna::vtmlua_push_value(lua, v.time_since_epoch().count());
         else if constexpr (std::is_same_v<T, span>)                  luna::vtmlua_push_value(lua, v.count());
         else if constexpr (std::is_convertible_v<T, sptr<ui::base>>) ::lua_pushlightuserdata(lua, (void*)v.get());
-        else if constexpr (!std::is_same_v<T, noop>)                 ::lua_pushlightuserdata(lua, (void*)&v);
         else if constexpr (is_string_v)                              ::lua_pushlstring(lua, v.data(), v.size());
         else if constexpr (is_cstring_v)                             ::lua_pushstring(lua, v);
+        else if constexpr (!std::is_same_v<T, noop>)                 ::lua_pushlightuserdata(lua, (void*)&v);
         else if constexpr (std::is_pointer_v<T>)                     ::lua_pushlightuserdata(lua, (void*)v);
         else if constexpr (std::is_same_v<T, twod> || std::is_same_v<T, fp2d>)
         {
@@ -350,18 +350,53 @@ namespace netxs::events
         auto ok = luna::run_with_gear_wo_return(proc);
         luna::set_return(ok);
     }
-    text luna::run(context_t& context, view script_body, auto&& param)
+    si32 luna::load(view script_body)
+    {
+        return ::luaL_loadbuffer(lua, script_body.data(), script_body.size(), "script body");
+    }
+    si32 luna::load(sptr<text> const& script_body_ptr)
+    {
+        // Push the compiled script body, compiling it only once while the body is alive.
+        auto iter = chunks.find(script_body_ptr.get());
+        if (iter != chunks.end())
+        {
+            auto& [body, fxid] = iter->second;
+            if (!body.expired()) // The address has not been reused by another body.
+            {
+                ::lua_rawgeti(lua, LUA_REGISTRYINDEX, fxid);
+                return LUA_OK;
+            }
+            ::luaL_unref(lua, LUA_REGISTRYINDEX, fxid);
+            chunks.erase(iter);
+        }
+        auto error = load(*script_body_ptr);
+        if (!error)
+        {
+            if (chunks.size() >= sweep) // Drop the chunks of the released bodies (e.g. after a configuration reload).
+            {
+                std::erase_if(chunks, [&](auto& rec)
+                {
+                    auto& [body, fxid] = rec.second;
+                    auto expired = body.expired();
+                    if (expired) ::luaL_unref(lua, LUA_REGISTRYINDEX, fxid);
+                    return expired;
+                });
+                sweep = std::max<size_t>(64, chunks.size() * 2);
+            }
+            ::lua_pushvalue(lua, -1);
+            auto fxid = ::luaL_ref(lua, LUA_REGISTRYINDEX); // Pop the function copy.
+            chunks.emplace(script_body_ptr.get(), chunk{ .body = script_body_ptr, .fxid = fxid });
+        }
+        return error;
+    }
+    text luna::exec(context_t& context, auto&& script, auto&& param)
     {
         using T = std::decay_t<decltype(param)>;
-        if constexpr (debugmode) log("%%script:\n%pads%%script%", prompt::lua, prompt::pads, ansi::hi(script_body));
-        //if constexpr (std::is_same_v<T, noop>) log("%%script:\n%pads%%script%", prompt::lua, prompt::pads, ansi::hi(script_body));
-        //else                                   log("%%script:\n%pads%%script%\n  with arg: %%", prompt::lua, prompt::pads, ansi::hi(script_body), param);
-
         indexer.context_ref = context;
         indexer.script_param = std::ref((T&)param);
 
         ::lua_settop(lua, 0);
-        auto error = ::luaL_loadbuffer(lua, script_body.data(), script_body.size(), "script body")
+        auto error = load(script)
                   || ::lua_pcall(lua, 0, 0, 0);
         indexer.script_param.reset();
         auto result = text{};
@@ -378,6 +413,18 @@ namespace netxs::events
         }
         return result;
     }
+    text luna::run(context_t& context, view script_body, auto&& param)
+    {
+        if constexpr (debugmode) log("%%script:\n%pads%%script%", prompt::lua, prompt::pads, ansi::hi(script_body));
+        //if constexpr (std::is_same_v<T, noop>) log("%%script:\n%pads%%script%", prompt::lua, prompt::pads, ansi::hi(script_body));
+        //else                                   log("%%script:\n%pads%%script%\n  with arg: %%", prompt::lua, prompt::pads, ansi::hi(script_body), param);
+        return exec(context, script_body, param);
+    }
+    text luna::run(context_t& context, sptr<text> const& script_body_ptr, auto&& param)
+    {
+        if constexpr (debugmode) log("%%script:\n%pads%%script%", prompt::lua, prompt::pads, ansi::hi(*script_body_ptr));
+        return exec(context, script_body_ptr, param);
+    }
     text luna::run_script(ui::base& boss, view script_body)
     {
         return run(boss.scripting_context, script_body);
@@ -405,7 +452,8 @@ namespace netxs::events
 
     luna::luna(auth& indexer)
         : indexer{ indexer },
-          lua{ ::luaL_newstate() }
+          lua{ ::luaL_newstate() },
+          sweep{ 64 }
     {
         ::luaL_openlibs(lua);
 
@@ -1040,6 +1088,12 @@ namespace netxs::ui
             time next; // caret: Time of next blinking.
             cell mark; // caret: Cursor brush.
 
+            // caret: Return the area the cursor can occupy (including the adjacent wide char half and the edge marker).
+            auto reach()
+            {
+                return rect{ body.coor - dot_10, body.size + dot_10 * 2 };
+            }
+
         public:
             caret(base&&) = delete;
             caret(base& boss, bool visible = faux, si32 cursor_style = text_cursor::I_bar, twod position = dot_00, span freq = skin::globals().blink_period, cell default_color = cell{})
@@ -1216,8 +1270,9 @@ namespace netxs::ui
                             {
                                 next = timestamp + step;
                                 live = !live;
-                                boss.base::deface(body);
+                                boss.base::retouch(reach());
                             }
+                            boss.bell::indexer.quartz.expect(next);
                         };
                     }
                     else
@@ -1300,7 +1355,7 @@ namespace netxs::ui
                     memo.clear();
                     if (done)
                     {
-                        boss.base::deface(body);
+                        boss.base::retouch(reach());
                         done = faux;
                     }
                 }
@@ -1526,6 +1581,7 @@ namespace netxs::ui
                         boss.base::signal(tier::preview, e2::conio::quit);
                         memo.clear();
                     }
+                    else if (wait) boss.bell::indexer.quartz.expect(stop);
                 };
             }
         };
@@ -1564,6 +1620,7 @@ namespace netxs::ui
                         ping.reset();
                         memo.clear();
                     }
+                    else boss.bell::indexer.quartz.expect(stop);
                 };
             }
         };
@@ -2483,23 +2540,41 @@ namespace netxs::ui
                   skill::memo;
 
             face bosscopy; // cache: Boss bitmap cache.
+            face scrapbox; // cache: Temp canvas for the damaged area.
             bool usecache; // cacheL .
             si32 lucidity; // cacheL .
+            bool rendered; // cache: The bitmap is maintained by the cache.
+            bool solid;    // cache: The bitmap has no transparent cells.
+
+            // cache: Return true if the specified area of the bitmap has no transparent cells.
+            auto opaque(rect area)
+            {
+                auto hole = faux;
+                bosscopy.each(area, [&](cell& c)
+                {
+                    hole = c.bga() != 0xFF || c.fga() != 0xFF;
+                    return hole;
+                });
+                return !hole;
+            }
 
         public:
             cache(base&&) = delete;
-            cache(base& boss, bool rendered = true)
+            cache(base& boss, bool rendered = true, bool lucent = true)
                 : skill{ boss },
                   usecache{ true },
-                  lucidity{ 0xFF }
+                  lucidity{ 0xFF },
+                  rendered{ rendered },
+                  solid{ faux }
             {
                 bosscopy.link(boss.bell::id);
                 bosscopy.size(boss.base::size());
                 boss.LISTEN(tier::preview, e2::form::prop::ui::cache, state, memo)
                 {
+                    if (state && !usecache) boss.base::ruined(true); // The bitmap was not updated while the cache was off.
                     usecache = state;
                 };
-                boss.LISTEN(tier::anycast, e2::form::prop::lucidity, value, memo)
+                if (lucent) boss.LISTEN(tier::anycast, e2::form::prop::lucidity, value, memo) // Skip it if the subtree applies the transparency on its own.
                 {
                     if (value < 0)
                     {
@@ -2515,6 +2590,7 @@ namespace netxs::ui
                     if (bosscopy.size() != new_area.size)
                     {
                         bosscopy.size(new_area.size);
+                        boss.base::ruined(true);
                     }
                 };
                 if (rendered)
@@ -2522,12 +2598,7 @@ namespace netxs::ui
                     boss.LISTEN(tier::release, e2::render::background::prerender, parent_canvas, memo)
                     {
                         if (!usecache) return;
-                        if (boss.base::ruined())
-                        {
-                            bosscopy.wipe();
-                            boss.base::ruined(faux);
-                            boss.base::signal(tier::release, e2::render::background::any, bosscopy);
-                        }
+                        update();
                         auto full = parent_canvas.full();
                         bosscopy.move(full.coor);
                         if (lucidity == 0xFF) parent_canvas.fill(bosscopy, cell::shaders::overlay);
@@ -2537,6 +2608,36 @@ namespace netxs::ui
                     };
                 }
             }
+            // cache: Redraw the damaged area of the bitmap.
+            void update()
+            {
+                if (!boss.base::ruined()) return;
+                auto area = boss.base::damaged().trim(bosscopy.area());
+                boss.base::ruined(faux);
+                if (area == bosscopy.area())
+                {
+                    bosscopy.wipe();
+                    boss.base::signal(tier::release, e2::render::background::any, bosscopy);
+                    solid = opaque(area);
+                }
+                else if (area) // Redraw only the damaged area and keep the rest of the bitmap.
+                {
+                    scrapbox.mark(bosscopy.mark());
+                    scrapbox.face::area(area);
+                    scrapbox.flow::full(bosscopy.flow::full());
+                    scrapbox.wipe();
+                    boss.base::signal(tier::release, e2::render::background::any, scrapbox);
+                    bosscopy.fill(scrapbox, cell::shaders::full);
+                    solid = opaque(solid ? area : bosscopy.area());
+                }
+            }
+            // cache: Return true if the up-to-date bitmap covers everything under the boss area.
+            bool opaque()
+            {
+                if (!rendered || !usecache || lucidity != 0xFF) return faux;
+                update();
+                return solid;
+            }
         };
 
         // pro: Acrylic blur.
@@ -2546,9 +2647,88 @@ namespace netxs::ui
             using skill::boss,
                   skill::memo;
 
-            si32 width; // acryl: Blur radius.
-            bool alive; // acryl: Is active.
-            vrgb cache; // acryl: Boxblur temp buffer.
+            using argbs = std::vector<argb>;
+
+            si32  width; // acryl: Blur radius.
+            bool  alive; // acryl: Is active.
+            vrgb  cache; // acryl: Boxblur temp buffer.
+            rect  place; // acryl: Area of the cached result.
+            argbs taken; // acryl: Background snapshot the cached result was made from.
+            argbs blurd; // acryl: Cached blurred background.
+
+            // acryl: Blur the canvas background reusing the cached result for the rows that are not affected by the changes since the previous frame.
+            void blur(face& parent_canvas)
+            {
+                auto shade = [](cell& c){ c.alpha(0xFF); };
+                auto full = parent_canvas.clip();
+                auto clip = full.trim(parent_canvas.area());
+                if (!clip) return;
+                auto w = clip.size.x;
+                auto h = clip.size.y;
+                auto s = (size_t)w * h;
+                auto row = [&](si32 y){ return parent_canvas.begin(clip.coor - parent_canvas.coor() + twod{ 0, y }); };
+                auto y0 = 0;
+                auto y1 = h;
+                if (place != clip || taken.size() != s)
+                {
+                    place = clip;
+                    taken.resize(s);
+                    blurd.resize(s);
+                }
+                else // Find the changed rows.
+                {
+                    auto same = [&](si32 y)
+                    {
+                        auto src = row(y);
+                        auto dst = taken.begin() + y * w;
+                        return std::equal(dst, dst + w, src, [](argb a, cell const& c){ return a == c.bgc(); });
+                    };
+                    while (y0 < h && same(y0)) y0++;
+                    if (y0 != h) while (same(y1 - 1)) y1--;
+                }
+                for (auto y = y0; y < y1; y++)
+                {
+                    auto src = row(y);
+                    std::transform(src, src + w, taken.begin() + y * w, [](cell const& c){ return c.bgc(); });
+                }
+                if (y0 != y1) // Two passes of the vertical blur spread the changes by 2 * width rows, and the band edges distort the same number of rows.
+                {
+                    auto reach = 2 * width;
+                    auto b0 = std::max(0, y0 - reach * 2);
+                    auto b1 = std::min(h, y1 + reach * 2);
+                    y0 = std::max(0, y0 - reach);
+                    y1 = std::min(h, y1 + reach);
+                    parent_canvas.clip({{ clip.coor.x, clip.coor.y + b0 }, { w, b1 - b0 }});
+                    parent_canvas.blur(width, cache, shade);
+                    parent_canvas.clip(full);
+                    for (auto y = y0; y < y1; y++)
+                    {
+                        auto src = row(y);
+                        std::transform(src, src + w, blurd.begin() + y * w, [](cell const& c){ return c.bgc(); });
+                    }
+                }
+                for (auto y = 0; y < h; y++) if (y < y0 || y >= y1)
+                {
+                    auto src = blurd.begin() + y * w;
+                    auto dst = row(y);
+                    std::for_each(src, src + w, [&](argb c){ dst++->bgc(c); });
+                }
+            }
+
+            // acryl: Turn off the bitmap cache of the nearest caching ancestor while blurring: the cached bitmap has no background to blur.
+            void share(base& parent)
+            {
+                parent.base::riseup(tier::preview, e2::form::prop::ui::cache, !alive);
+            }
+            // acryl: Switch the effect.
+            void toggle(bool state)
+            {
+                if (std::exchange(alive, state) != state)
+                if (auto parent_ptr = boss.base::parent())
+                {
+                    share(*parent_ptr);
+                }
+            }
 
         public:
             acryl(base&&) = delete;
@@ -2559,16 +2739,20 @@ namespace netxs::ui
             {
                 boss.LISTEN(tier::preview, e2::form::prop::ui::acryl, state, memo)
                 {
-                    alive = state;
+                    toggle(state);
                 };
                 boss.LISTEN(tier::anycast, e2::form::prop::lucidity, lucidity, memo)
                 {
-                    if (lucidity != -1) alive = lucidity == 0xFF;
+                    if (lucidity != -1) toggle(lucidity == 0xFF);
+                };
+                boss.LISTEN(tier::release, e2::form::upon::vtree::attached, parent_ptr, memo)
+                {
+                    if (alive && parent_ptr) share(*parent_ptr);
                 };
                 boss.LISTEN(tier::release, e2::render::background::prerender, parent_canvas, memo)
                 {
                     if (!alive) return;
-                    parent_canvas.blur(width, cache, [&](cell& c){ c.alpha(0xFF); });
+                    blur(parent_canvas);
                 };
             }
         };
@@ -1111,20 +1111,57 @@ namespace netxs::directvt
                     }
                     else bad = true;
                 };
-                while (src != mid && !abort)
+                auto scan = [&](auto stop) // Skip unchanged runs in bulk.
                 {
-                    auto stop = src + min.x;
-                    while (src != stop) map(*src++, *dst++);
-                    if (dtx >= 0) dst += dtx;
-                    else
+                    while (src != stop)
+                    {
+                        if (*src != *dst) map(*src++, *dst++);
+                        else
+                        {
+                            auto n = netxs::mismatch({ src, stop }, { dst, (size_t)(stop - src) });
+                            src += n;
+                            dst += n;
+                            bad = true;
+                        }
+                    }
+                };
+                auto& dirty = cache.dirty();
+                auto track = fsz == csz && dirty.size() == (size_t)csz.y;
+                if (track) // Scan only the journaled spans.
+                {
+                    auto row = cache.begin();
+                    auto old = image.begin();
+                    for (auto band : dirty)
                     {
-                        stop += -dtx;
-                        while (src != stop) map(*src++, pen);
+                        if (abort) break;
+                        if (band.x < band.y)
+                        {
+                            src = row + band.x;
+                            dst = old + band.x;
+                            bad = true; // Force insertion point.
+                            scan(row + band.y);
+                        }
+                        row += csz.x;
+                        old += csz.x;
                     }
                 }
-                if (csz.y > fsz.y)
+                else
                 {
-                    while (src != end && !abort) map(*src++, pen);
+                    while (src != mid && !abort)
+                    {
+                        auto stop = src + min.x;
+                        scan(stop);
+                        if (dtx >= 0) dst += dtx;
+                        else
+                        {
+                            stop += -dtx;
+                            while (src != stop) map(*src++, pen);
+                        }
+                    }
+                    if (csz.y > fsz.y)
+                    {
+                        while (src != end && !abort) map(*src++, pen);
+                    }
                 }
                 if (sum) rep();
                 if (abort)
@@ -1132,10 +1169,16 @@ namespace netxs::directvt
                     std::swap(state, pen);
                     sum = reset();
                 }
+                else if (track)
+                {
+                    image.flush(cache);
+                    sum = commit(true);
+                }
                 else
                 {
                     auto discard_empty = fsz == csz;
                     std::swap(image, cache);
+                    cache.taint();
                     sum = commit(discard_empty);
                 }
                 delta = sum;
@@ -1252,6 +1295,13 @@ namespace netxs::directvt
                 : stream{ Kind }
             { }
 
+            // bitmap_a: Forget the terminal state to redraw the entire next frame starting with the default attributes.
+            void renew()
+            {
+                state = {};
+                image.hash(image.hash() - 1);
+                stream::block.basevt::nil();
+            }
             void set(id_t /*winid*/, twod /*winxy*/, core& cache, flag& abort, sz_t& delta)
             {
                 auto coord = dot_00;
@@ -1292,6 +1342,7 @@ namespace netxs::directvt
                     utf::reverse_clusters(cluster, stream::block);
                 };
                 auto src = cache.begin();
+                auto track = faux; // Scan only the rows listed in the dirty span journal.
                 if (image.hash() != cache.hash()) // The cache has been resized.
                 {
                     stream::block.basevt::scroll_wipe();
@@ -1396,6 +1447,8 @@ namespace netxs::directvt
                     };
                     auto dst = image.begin();
                     auto bad_cells = 0; // Possibly corrupted cell count.
+                    auto& dirty = cache.dirty();
+                    track = image.size() == field && dirty.size() == (size_t)field.y;
                     coord = dot_mx;
                     auto coord_y = 0;
                     while (coord_y < field.y)
@@ -1404,12 +1457,27 @@ namespace netxs::directvt
                         {
                             delta = reset();
                             state = saved;
+                            track = faux;
                             break;
                         }
+                        if (track && !bad_cells && dirty[coord_y].x >= dirty[coord_y].y) // Skip the clean row.
+                        {
+                            src += field.x;
+                            dst += field.x;
+                            ++coord_y;
+                            continue;
+                        }
                         auto beg = src + 1;
                         auto end = src + field.x;
                         while (src != end)
                         {
+                            if (!bad_cells && *src == *dst) // Skip unchanged runs in bulk.
+                            {
+                                auto n = netxs::mismatch({ src, end }, { dst, (size_t)(end - src) });
+                                src += n;
+                                dst += n;
+                                if (src == end) break;
+                            }
                             auto& c = *src++; // Current frame.
                             auto& p = *dst++; // Previous shot.
                             if (bad_cells || c != p)
@@ -1512,7 +1580,12 @@ namespace netxs::directvt
                         ++coord_y;
                     }
                 }
-                std::swap(image, cache);
+                if (track) image.flush(cache);
+                else
+                {
+                    std::swap(image, cache);
+                    cache.taint();
+                }
                 delta = commit(true);
             }
             void get(view& /*data*/) { }
@@ -1556,6 +1629,7 @@ namespace netxs::directvt
                     }
                 };
                 auto src = cache.begin();
+                auto track = faux; // Scan only the rows listed in the dirty span journal.
                 if (image.hash() != cache.hash()) // The cache has been resized.
                 {
                     stream::block.locate(coord);
@@ -1677,6 +1751,8 @@ namespace netxs::directvt
                         }
                     };
                     auto dst = image.begin();
+                    auto& dirty = cache.dirty();
+                    track = image.size() == field && dirty.size() == (size_t)field.y;
                     coord = dot_mx;
                     auto coord_y = 0;
                     while (coord_y < field.y)
@@ -1685,12 +1761,27 @@ namespace netxs::directvt
                         {
                             delta = reset();
                             state = saved;
+                            track = faux;
                             break;
                         }
+                        if (track && dirty[coord_y].x >= dirty[coord_y].y) // Skip the clean row.
+                        {
+                            src += field.x;
+                            dst += field.x;
+                            ++coord_y;
+                            continue;
+                        }
                         auto beg = src + 1;
                         auto end = src + field.x;
                         while (src != end)
                         {
+                            if (*src == *dst) // Skip unchanged runs in bulk.
+                            {
+                                auto n = netxs::mismatch({ src, end }, { dst, (size_t)(end - src) });
+                                src += n;
+                                dst += n;
+                                if (src == end) break;
+                            }
                             auto& c = *src++; // Current frame.
                             auto& p = *dst++; // Previous shot.
                             if (c != p)
@@ -1782,7 +1873,12 @@ namespace netxs::directvt
                         defer.resize(start);
                     }
                 }
-                std::swap(image, cache);
+                if (track) image.flush(cache);
+                else
+                {
+                    std::swap(image, cache);
+                    cache.taint();
+                }
                 delta = commit(true);
             }
             void get(view& /*data*/) { }
@@ -1885,22 +1981,21 @@ namespace netxs::directvt
             // s11n: Request jumbo clusters (after received bitmap synchronization).
             void request_jgc(auto& master)
             {
-                auto jumbos = cell::glyf::jumbos();
-                if (jumbos.unk.size())
+                auto unknown = cell::glyf::jumbos().unk();
+                if (unknown.size())
                 {
                     auto list = s11n::request_gc.freeze();
-                    for (auto& token : jumbos.unk)
+                    for (auto& token : unknown)
                     {
                         list.thing.push(token);
                     }
-                    jumbos.unk.clear();
                     list.thing.sendby(master);
                 }
             }
             // s11n: Receive jumbo clusters.
             void receive_jgc(s11n::xs::jgc_list& lock)
             {
-                auto jumbos = cell::glyf::jumbos();
+                auto& jumbos = cell::glyf::jumbos();
                 for (auto& jgc : lock.thing)
                 {
                     jumbos.set(jgc.token, jgc.cluster);
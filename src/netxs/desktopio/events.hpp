@@ -141,8 +141,16 @@ namespace netxs::events
     // events: Lua scripting.
     struct luna
     {
+        struct chunk
+        {
+            wptr<text> body; // luna::chunk: Script body the function was compiled from.
+            si32       fxid; // luna::chunk: Registry reference to the compiled function.
+        };
+
         auth&      indexer; // luna: .
         lua_State* lua; // luna: .
+        std::unordered_map<text const*, chunk> chunks; // luna: Compiled script bodies indexed by their identity.
+        size_t     sweep; // luna: The chunk cache size that triggers the removal of expired entries.
 
         static text vtmlua_torawstring(lua_State* lua, si32 idx, bool extended = faux);
         static si32 vtmlua_object2string(lua_State* lua);
@@ -162,8 +170,13 @@ namespace netxs::events
         input::hids& get_gear();
         bool run_with_gear_wo_return(auto proc);
         void run_with_gear(auto proc);
+        si32 load(view script_body);
+        si32 load(sptr<text> const& script_body_ptr);
+        text exec(context_t& context, auto&& script, auto&& param);
         template<class Arg = noop>
         text run(context_t& context, view script_body, Arg&& param = {});
+        template<class Arg = noop>
+        text run(context_t& context, sptr<text> const& script_body_ptr, Arg&& param = {});
         text run_script(ui::base& object, view script_body);
         void run_ext_script(ui::base& object, auto& script);
 
@@ -222,8 +235,7 @@ namespace netxs::events
             if (script_ptr && script_ptr->script_body_ptr)
             {
                 auto& [context, script_body_ptr] = *script_ptr;
-                auto& script_body = *script_body_ptr;
-                luafx.run(context, script_body, param);
+                luafx.run(context, script_body_ptr, param);
             }
             else if (auto& proc = get_inst<Arg>())
             {
@@ -251,7 +263,50 @@ namespace netxs::events
     };
 
     using wook = wptr<fxbase>;
-    using fmap = std::unordered_map<hint, std::list<wptr<fxbase>>>; // Functor wptr-list map by event_id.
+
+    // events: Flat subscriber array of a single event id.
+    struct fxvec
+    {
+        std::vector<wook> items; // fxvec: Subscribers in subscription order. Expired and erased entries stay in place as tombstones until the compaction.
+        si32              users; // fxvec: Number of dispatch passes currently iterating over the items.
+        sz_t              holes; // fxvec: Number of tombstones met since the last compaction.
+
+        fxvec()
+            : users{ 0 },
+              holes{ 0 }
+        { }
+
+        auto size() const  { return items.size();  }
+        auto empty() const { return items.empty(); }
+        void push_back(wook const& fx_wptr)
+        {
+            if (holes > items.size() / 2) compact();
+            items.push_back(fx_wptr);
+        }
+        // fxvec: Remove tombstones unless the items are being iterated. Return the number of removed entries.
+        sz_t compact()
+        {
+            if (users) return 0;
+            auto count = (sz_t)std::erase_if(items, [](auto& fx_wptr){ return fx_wptr.expired(); });
+            holes = 0;
+            return count;
+        }
+        // fxvec: Erase the subscribers for which pred returns true.
+        void erase_if(auto pred)
+        {
+            for (auto& fx_wptr : items)
+            {
+                if (pred(fx_wptr))
+                {
+                    fx_wptr.reset();
+                    holes++;
+                }
+            }
+            compact();
+        }
+    };
+
+    using fmap = std::unordered_map<hint, sptr<fxvec>>; // Functor wptr-array map by event_id.
     using fxmap = utf::unordered_map<text, std::function<void()>>; // Class methods.
 
     // Class methods and registered instances.
@@ -289,7 +344,6 @@ namespace netxs::events
         hint                                      e2_timer_tick_id;
         si32                                      handled{}; // auth: Last notify operation result.
         std::vector<std::pair<hint, si32>>        queue; // auth: Event queue: { event_id, call state }.
-        std::vector<wptr<fxbase>>                 qcopy; // auth: Copy of the current pretenders to exec on current event.
         std::vector<bool>                         gear_indexing; // auth: Gear visual indexing.
         sptr<input::hids>                         _null_gear_sptr; // auth: Fallback gear sptr.
         core                                      _null_idmap; // auth: Fallback gear idmap.
@@ -299,6 +353,24 @@ namespace netxs::events
         hint                                      chord_index{}; // auth: Next available keybd chord index.
         hint                                      anykey_event{};
 
+        // auth: Subscriber arrays selected for the event, in calling order, with their lengths at the moment of selection.
+        struct track
+        {
+            static constexpr auto limit = sizeof(hint) * 8 / events::block; // track: Maximum number of event levels.
+
+            std::array<std::pair<sptr<fxvec>, sz_t>, limit> lists;
+            si32                                            count = 0;
+
+            void add(fmap& reactor, hint event_key)
+            {
+                auto iter = reactor.find(event_key);
+                if (iter != reactor.end() && iter->second->size() && count < (si32)limit)
+                {
+                    lists[count++] = { iter->second, iter->second->size() }; // Hold the array in case the owner is gone during the call.
+                }
+            }
+        };
+
         auto get_kbchord_hint(qiew chord)
         {
             auto iter = keybd_chords.find(chord);
@@ -329,13 +401,11 @@ namespace netxs::events
         {
             auto lref = ui64{};
             auto ldel = ui64{};
-            for (auto& [event, fxlist] : reactor)
+            for (auto& [event, fxlist_ptr] : reactor)
             {
-                auto refs = fxlist.size();
-                fxlist.remove_if([](auto&& a){ return a.expired(); });
-                auto size = fxlist.size();
-                lref += size;
-                ldel += refs - size;
+                auto& fxlist = *fxlist_ptr;
+                ldel += fxlist.compact();
+                lref += fxlist.size();
             }
             ref_count += lref;
             del_count += ldel;
@@ -347,7 +417,9 @@ namespace netxs::events
         void _subscribe_copy(si32 Tier, fmap& reactor, hint event, hook& proc_ptr)
         {
             auto& target_reactor = Tier == tier::general ? general : reactor;
-            target_reactor[event | tier_mask(Tier)].push_back(proc_ptr);
+            auto& fxlist_ptr = target_reactor[event | tier_mask(Tier)];
+            if (!fxlist_ptr) fxlist_ptr = ptr::shared<fxvec>();
+            fxlist_ptr->push_back(proc_ptr);
         }
         template<class Arg>
         auto _subscribe(si32 Tier, fmap& reactor, hint event, fx<Arg>&& proc)
@@ -366,26 +438,21 @@ namespace netxs::events
         auth(bool use_timer = faux);
 
         ui::base* get_target(context_t& source_ctx, view object_name);
-        // auth: .
-        void _refresh_and_copy(fmap::mapped_type& fxlist)
-        {
-            fxlist.remove_if([&](auto& f){ return f.expired() ? true : (qcopy.emplace_back(f), faux); });
-        }
-        // auth: .
+        // auth: Select the subscriber arrays of the event and its parent groups.
         auto _select(si32 Tier, fmap& reactor, hint event, feed order)
         {
             auto tiermask = tier_mask(Tier);
-            auto head = qcopy.size();
+            auto picks = track{};
             if (order == feed::fwd)
             {
                 auto itermask = events::level_mask(event);
                 auto subgroup = event;
-                _refresh_and_copy(reactor[subgroup | tiermask]);
+                picks.add(reactor, subgroup | tiermask);
                 while (itermask > (1 << events::block)) // Skip root event block.
                 {
                     subgroup = event & itermask;
                     itermask >>= events::block;
-                    _refresh_and_copy(reactor[subgroup | tiermask]);
+                    picks.add(reactor, subgroup | tiermask);
                 }
             }
             else if (order == feed::rev)
@@ -397,37 +464,52 @@ namespace netxs::events
                 {
                     itermask = (itermask << events::block) | mask;
                     subgroup = event & itermask;
-                    _refresh_and_copy(reactor[subgroup | tiermask]);
+                    picks.add(reactor, subgroup | tiermask);
                 }
                 while (subgroup != event);
             }
             else
             {
-                _refresh_and_copy(reactor[event | tiermask]);
+                picks.add(reactor, event | tiermask);
+            }
+            return picks;
+        }
+        // auth: Iterate over the selected subscribers in place while proc(fxlist, index) returns true.
+        //       Subscribers added during the pass are not visited; tombstones are compacted after the last pass.
+        void _dispatch(track& picks, auto proc)
+        {
+            auto alive = true;
+            for (auto i = 0; i < picks.count && alive; i++)
+            {
+                auto& [fxlist_ptr, size] = picks.lists[i];
+                auto& fxlist = *fxlist_ptr;
+                fxlist.users++;
+                for (auto n = sz_t{}; n < size && alive; n++)
+                {
+                    if (fxlist.items[n].expired()) fxlist.holes++; // items can be reallocated.
+                    else                           alive = proc(fxlist, n);
+                }
+                if (!--fxlist.users && fxlist.holes) fxlist.compact();
             }
-            auto tail = qcopy.size();
-            return std::pair{ head, tail };
         }
         // auth: Calling delegates. Returns the number of active ones.
         void _notify(si32 Tier, fmap& reactor, hint event, auto& param)
         {
             auto order = tier::order[Tier];
-            auto [head, tail] = _select(Tier, reactor, event, order);
-            if (head != tail)
+            auto picks = _select(Tier, reactor, event, order);
+            if (picks.count)
             {
                 queue.emplace_back(event, callstate::not_handled);
-                auto iter = head;
-                do
+                _dispatch(picks, [&](fxvec& fxlist, sz_t n)
                 {
-                    if (auto fx_ptr = qcopy[iter].lock()) // qcopy can be reallocated.
+                    if (auto fx_ptr = fxlist.items[n].lock())
                     {
                         auto& state = queue.back().second; // queue can be reallocated.
                         state = callstate::proceed;
                         fx_ptr->call(luafx, param);
                     }
-                }
-                while (queue.back().second/*callstate*/ != callstate::fullstop && ++iter != tail);
-                qcopy.resize(head);
+                    return queue.back().second/*callstate*/ != callstate::fullstop;
+                });
                 handled = queue.back().second/*callstate*/ != callstate::not_handled;
                 queue.pop_back();
             }
@@ -482,8 +564,30 @@ namespace netxs::events
         // auth: .
         void timer(time now)
         {
-            auto lock = sync();
-            _notify(tier::general, general, e2_timer_tick_id, now);
+            // Release the lock between tick handlers to let input and output threads pass through
+            // instead of waiting for the rendering of all windows at once. The selected arrays
+            // are not compacted until the pass is over: fxvec::users keeps the indices valid.
+            auto lock = unique_lock();
+            auto order = tier::order[tier::general];
+            auto picks = _select(tier::general, general, e2_timer_tick_id, order);
+            auto first = true;
+            _dispatch(picks, [&](fxvec& fxlist, sz_t n)
+            {
+                if (!std::exchange(first, faux))
+                {
+                    lock.unlock();
+                    lock.lock();
+                }
+                if (auto fx_ptr = fxlist.items[n].lock())
+                {
+                    queue.emplace_back(e2_timer_tick_id, callstate::proceed);
+                    fx_ptr->call(luafx, now);
+                    auto state = queue.back().second;
+                    queue.pop_back();
+                    if (state == callstate::fullstop) return faux;
+                }
+                return true;
+            });
         }
         // auth: Delete object instance.
         template<class T>
@@ -555,6 +659,7 @@ namespace netxs::events
                     if constexpr (!Sync) lock.unlock();
                     proc(*object_ptr);
                     if constexpr (!Sync) lock.lock();
+                    quartz.wake(); // Let the timer listeners see the outcome.
                 }
             });
         }
@@ -778,7 +883,7 @@ namespace netxs::events
             auto event_key = event_id | indexer.tier_mask(tier_id);
             auto& r = tier_id == tier::general ? indexer.general : reactor;
             auto iter = r.find(event_key);
-            return iter != r.end() ? iter->second.size() : 0;
+            return iter != r.end() ? iter->second->size() : 0;
         }
         // bell: Erase all script handlers for the specified event.
         void erase_script_handlers(si32 tier_id, hint event_id)
@@ -788,8 +893,8 @@ namespace netxs::events
             auto iter = r.find(event_key);
             if (iter != r.end())
             {
-                auto& fx_list = iter->second;
-                std::erase_if(fx_list, [&](auto& fx_wptr) // Clear handlers.
+                auto& fx_list = *(iter->second);
+                fx_list.erase_if([&](auto& fx_wptr) // Clear handlers.
                 {
                     if (auto fx_sptr = fx_wptr.lock())
                     {
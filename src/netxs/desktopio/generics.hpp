@@ -156,63 +156,86 @@ namespace netxs::generics
         { }
     };
 
-    // generics: .
-    template<class T>
-    class mt_queue
+    // generics: Move-only callable that keeps small closures inline (no heap allocation).
+    template<class Sig, sz_t Size = 64>
+    class thunk;
+    template<class R, class ...Args, sz_t Size>
+    class thunk<R(Args...), Size>
     {
-        std::mutex              d_mutex;
-        std::condition_variable d_condition;
-        std::deque<T>           d_queue;
+        using call_t = R(*)(void*, Args...);
+        using hand_t = void(*)(void* dst, void* src); // Move src to dst (or destroy src if dst is null).
+
+        template<class F>
+        static constexpr auto local = sizeof(F) <= Size && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+
+        alignas(std::max_align_t) byte data[Size];
+        call_t call{};
+        hand_t hand{};
 
     public:
-        void push(T const& value)
+        thunk() = default;
+        thunk(thunk&& t) noexcept
+            : call{ std::exchange(t.call, nullptr) },
+              hand{ std::exchange(t.hand, nullptr) }
         {
-            auto guard = std::lock_guard{ d_mutex };
-            d_queue.push_front(value);
-            d_condition.notify_one();
+            if (hand) hand(data, t.data);
         }
-        T pop()
-        {
-            auto lock = std::unique_lock{ d_mutex };
-            d_condition.wait(lock, [this]{ return !d_queue.empty(); });
-            T rc(std::move(d_queue.back()));
-            d_queue.pop_back();
-            return rc;
-        }
-        bool try_pop(T& v, std::chrono::milliseconds timeout)
+        template<class P>
+        requires(!std::is_same_v<std::decay_t<P>, thunk>)
+        thunk(P&& proc)
         {
-            auto lock = std::unique_lock{ d_mutex };
-            if (!d_condition.wait_for(lock, timeout, [this]{ return !d_queue.empty(); }))
+            using F = std::decay_t<P>;
+            if constexpr (local<F>)
+            {
+                ::new (data) F(std::forward<P>(proc));
+                call = [](void* p, Args... args) -> R { return (*static_cast<F*>(p))(std::forward<Args>(args)...); };
+                hand = [](void* dst, void* src)
+                {
+                    auto& f = *static_cast<F*>(src);
+                    if (dst) ::new (dst) F(std::move(f));
+                    f.~F();
+                };
+            }
+            else // Large closures are kept on the heap.
             {
-                return !true;
+                ::new (data) F*(new F(std::forward<P>(proc)));
+                call = [](void* p, Args... args) -> R { return (**static_cast<F**>(p))(std::forward<Args>(args)...); };
+                hand = [](void* dst, void* src)
+                {
+                    auto f = *static_cast<F**>(src);
+                    if (dst) ::new (dst) F*(f);
+                    else     delete f;
+                };
             }
-            v = d_queue.back();
-            d_queue.pop_back();
-            return true;
         }
-        size_t size()
+       ~thunk()
         {
-            auto guard = std::lock_guard{ d_mutex };
-            return d_queue.size();
+            reset();
         }
-        void clear()
+        thunk& operator = (thunk&& t) noexcept
+        {
+            if (this != &t)
+            {
+                reset();
+                call = std::exchange(t.call, nullptr);
+                hand = std::exchange(t.hand, nullptr);
+                if (hand) hand(data, t.data);
+            }
+            return *this;
+        }
+        void reset()
         {
-            auto guard = std::lock_guard{ d_mutex };
-            d_queue.clear();
+            if (hand) hand(nullptr, data);
+            call = nullptr;
+            hand = nullptr;
         }
-
-        mt_queue() { }
-        mt_queue(mt_queue<T>&& x)
+        explicit operator bool () const
         {
-            auto guard = std::lock_guard{ d_mutex };
-            d_queue = std::move(x.d_queue);
+            return call != nullptr;
         }
-        mt_queue<T>& operator = (mt_queue<T>&& x)
+        R operator () (Args... args)
         {
-            //todo *this is not a MT safe (only x.d_mutex is locked)
-            auto guard = std::lock_guard{ d_mutex };
-            d_queue = std::move(x.d_queue);
-            return *this;
+            return call(data, std::forward<Args>(args)...);
         }
     };
 
@@ -221,12 +244,15 @@ namespace netxs::generics
     struct jobs
     {
         using token = T;
-        using func = std::function<void(token&)>;
+        using func = thunk<void(token&)>;
         using item = std::pair<token, func>;
+        using list = std::vector<item>;
 
         std::mutex              mutex;
         std::condition_variable synch;
-        std::list<item>         queue;
+        list                    queue; // jobs: Incoming tasks.
+        list                    batch; // jobs: Tasks being executed (the queue is swapped with it in one step).
+        sz_t                    drain; // jobs: Position of the running task in the batch.
         flag                    alive;
         std::thread             agent;
 
@@ -234,31 +260,45 @@ namespace netxs::generics
         void cancel(P&& deactivate)
         {
             auto guard = std::unique_lock{ mutex };
+            for (auto i = drain; i < batch.size(); i++)
+            {
+                auto& token = batch[i].first;
+                deactivate(token);
+            }
             for (auto& job : queue)
             {
                 auto& token = job.first;
                 deactivate(token);
             }
         }
+        // jobs: Return the number of pending tasks including the running one.
+        auto size()
+        {
+            auto guard = std::unique_lock{ mutex };
+            return queue.size() + batch.size() - drain;
+        }
         void worker()
         {
             auto guard = std::unique_lock{ mutex };
             while (alive)
             {
                 if (queue.empty() /* Not empty at startup */) synch.wait(guard);
-                while (queue.size())
+                std::swap(queue, batch); // Both keep their capacity, so there is no allocation after warming up.
+                for (drain = 0; drain < batch.size(); drain++)
                 {
-                    auto& [token, proc] = queue.front();
+                    auto& [token, proc] = batch[drain];
                     guard.unlock();
                     proc(token);
                     guard.lock();
-                    queue.pop_front();
                 }
+                batch.clear();
+                drain = 0;
             }
         }
 
         jobs()
-            : alive{ true },
+            : drain{ 0 },
+              alive{ true },
               agent{ &jobs::worker, this }
         { }
        ~jobs()
@@ -271,19 +311,7 @@ namespace netxs::generics
             auto guard = std::lock_guard{ mutex };
             if (alive)
             {
-                if constexpr (std::is_copy_constructible_v<P>)
-                {
-                    queue.emplace_back(std::forward<TT>(token), std::forward<P>(proc));
-                }
-                else
-                {
-                    //todo issue with MSVC: Generalized lambda capture does't work.
-                    auto proxy = std::make_shared<std::decay_t<P>>(std::forward<P>(proc));
-                    queue.emplace_back(std::forward<TT>(token), [proxy](auto&&... args)->decltype(auto)
-                    {
-                        return (*proxy)(decltype(args)(args)...);
-                    });
-                }
+                queue.emplace_back(std::forward<TT>(token), std::forward<P>(proc));
             }
             synch.notify_one();
         }
@@ -387,6 +415,119 @@ namespace netxs::generics
         { }
     };
 
+    // generics: Fenwick tree (binary indexed tree) of prefix sums over non-negative values.
+    template<class T>
+    struct fenwick
+    {
+        std::vector<T> tree;
+
+        auto size() const
+        {
+            return (si32)tree.size() - 1;
+        }
+        // fenwick: Build the tree from the values in O(n).
+        void reset(std::vector<T> const& values)
+        {
+            tree.resize(values.size() + 1);
+            tree[0] = {};
+            std::copy(values.begin(), values.end(), tree.begin() + 1);
+            for (auto i = si32{ 1 }; i <= size(); i++)
+            {
+                auto j = i + (i & -i);
+                if (j <= size()) tree[j] += tree[i];
+            }
+        }
+        // fenwick: Add delta to the value at the specified position.
+        void add(si32 i, T delta)
+        {
+            for (++i; i <= size(); i += i & -i) tree[i] += delta;
+        }
+        // fenwick: Return the sum of the values in [0, n).
+        auto sum(si32 n) const
+        {
+            auto s = T{};
+            for (; n > 0; n -= n & -n) s += tree[n];
+            return s;
+        }
+        // fenwick: Return the largest n such that sum(n) <= value.
+        auto find(T value) const
+        {
+            auto n = si32{};
+            for (auto step = (si32)std::bit_floor((ui32)size()); step; step >>= 1)
+            {
+                if (n + step <= size() && tree[n + step] <= value)
+                {
+                    n += step;
+                    value -= tree[n];
+                }
+            }
+            return n;
+        }
+    };
+
+    // generics: Lock-free log-linear histogram of non-negative values (the value of each bucket is within 1/8 of its samples).
+    struct hist
+    {
+        static constexpr auto bits = 3; // hist: Sub-bucket bits per power of two.
+        static constexpr auto subs = 1 << bits;
+
+        std::array<std::atomic<ui32>, 64 * subs> slot{}; // hist: Sample counters.
+
+        // hist: Return the bucket index for the value.
+        static auto index(ui64 value)
+        {
+            if (value < subs) return (si32)value;
+            auto e = (si32)std::bit_width(value) - 1;
+            return (e - bits + 1) * subs + (si32)((value >> (e - bits)) & (subs - 1));
+        }
+        // hist: Return the middle value of the bucket.
+        static auto value(si32 index)
+        {
+            if (index < subs) return (ui64)index;
+            auto e = index / subs + bits - 1;
+            auto s = e - bits;
+            return ((ui64)(subs + index % subs) << s) + (((ui64)1 << s) >> 1);
+        }
+        // hist: Add a sample.
+        void add(ui64 value)
+        {
+            slot[index(value)].fetch_add(1, std::memory_order_relaxed);
+        }
+        // hist: Add a duration sample in nanoseconds.
+        void add(span delta)
+        {
+            add((ui64)std::max<si64>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(delta).count()));
+        }
+        // hist: Return the number of samples.
+        auto count() const
+        {
+            auto n = ui64{};
+            for (auto& s : slot) n += s.load(std::memory_order_relaxed);
+            return n;
+        }
+        // hist: Return the value below which the specified fraction of samples falls.
+        auto quantile(fp64 q) const
+        {
+            auto copy = std::array<ui32, 64 * subs>{};
+            auto n = ui64{};
+            for (auto i = 0; i < (si32)slot.size(); i++) n += copy[i] = slot[i].load(std::memory_order_relaxed);
+            if (!n) return ui64{};
+            auto rank = (ui64)std::ceil(std::clamp(q, 0.0, 1.0) * (fp64)n);
+            auto seen = ui64{};
+            for (auto i = 0; i < (si32)copy.size(); i++)
+            {
+                seen += copy[i];
+                if (seen >= std::max<ui64>(rank, 1)) return value(i);
+            }
+            return value((si32)copy.size() - 1);
+        }
+        // hist: Drop all samples.
+        void reset()
+        {
+            for (auto& s : slot) s.store(0, std::memory_order_relaxed);
+        }
+    };
+
     // generics: .
     template<class vect, bool UseUndock = faux>
     struct ring
@@ -401,6 +542,7 @@ namespace netxs::generics
         si32 size; // ring: Elements count.
         si32 cart; // ring: Active item position.
         si32 mxsz; // ring: Max unlimited buffer size.
+        si32 epoch; // ring: Reallocation counter.
 
         void inc(si32& a) const {  if (++a == peak) a = 0;        }
         void dec(si32& a) const {  if (--a < 0    ) a = peak - 1; }
@@ -428,8 +570,9 @@ namespace netxs::generics
             auto  operator -- (int)                 { auto temp = iter<Ring>{ buff, addr }; buff.dec(addr); return temp;  }
             auto& operator ++ ()                    {                                       buff.inc(addr); return *this; }
             auto& operator -- ()                    {                                       buff.dec(addr); return *this; }
-            auto& operator *  ()                    { return buff.buff[addr];                                             }
-            auto  operator -> ()                    { return buff.buff.begin() + addr;                                    }
+            auto& operator *  ()                    { return ring::touch(buff.buff[addr]);                                }
+            auto  operator -> ()                    { ring::touch(buff.buff[addr]); return buff.buff.begin() + addr;      }
+            auto& peek        ()              const { return buff.buff[addr];                                             } // Access the item as is.
             auto  operator != (iter const& m) const { return addr != m.addr;                                              }
             auto  operator == (iter const& m) const { return addr == m.addr;                                              }
         };
@@ -442,26 +585,36 @@ namespace netxs::generics
               buff(peak), // Rounded brackets! Not curly! In oreder to call T::ctor().
               size{ 0 },
               cart{ 0 },
-              mxsz{ std::clamp(grow_mx, 0, netxs::si32max - 2) }
+              mxsz{ std::clamp(grow_mx, 0, netxs::si32max - 2) },
+              epoch{ 0 }
         { }
 
         virtual void undock_base_front(type&) { };
         virtual void undock_base_back (type&) { };
 
+        // ring: Prepare the item for mutable access if it is stored in a packed form. Const access gets the item as is.
+        static auto& touch(auto& item)
+        {
+            if constexpr (requires{ item.thaw(); }) item.thaw();
+            return item;
+        }
+
         auto  current_it()         { return iter<      ring>{ *this, cart };          }
         auto  begin()              { return iter<      ring>{ *this, head };          }
         auto    end()              { return iter<      ring>{ *this, mod(tail + 1) }; }
         auto  begin() const        { return iter<const ring>{ *this, head };          }
         auto    end() const        { return iter<const ring>{ *this, mod(tail + 1) }; }
         auto& length() const       { return size;                }
-        auto&  back()              { return buff[tail];          }
-        auto&  back() const        { return buff[tail];          }
-        auto& front()              { return buff[head];          }
-        auto& front() const        { return buff[head];          }
-        auto& current     ()       { return buff[cart];          }
-        auto& operator  * ()       { return buff[cart];          }
-        auto  operator -> ()       { return buff.begin() + cart; }
-        auto&          at (si32 i) { assert(i >= 0 && i < size); return buff[mod(head + i)]; }
+        auto&  back()              { return touch(buff[tail]);   }
+        auto&  back() const        { return touch(buff[tail]);   }
+        auto& front()              { return touch(buff[head]);   }
+        auto& front() const        { return touch(buff[head]);   }
+        auto& current     ()       { return touch(buff[cart]);   }
+        auto& operator  * ()       { return touch(buff[cart]);   }
+        auto  operator -> ()       { touch(buff[cart]); return buff.begin() + cart; }
+        auto&          at (si32 i) { assert(i >= 0 && i < size); return touch(buff[mod(head + i)]); }
+        auto&        peek (si32 i)       { assert(i >= 0 && i < size); return buff[mod(head + i)]; } // Access the item as is.
+        auto&        peek (si32 i) const { assert(i >= 0 && i < size); return buff[mod(head + i)]; } // Access the item as is.
         auto& operator [] (si32 i) { return at(i);               }
         auto  index() const        { return dst(head, cart);     }
         void  index(si32 i)        { assert((i > 0 && i < size) || i == 0); cart = mod(head + i); }
@@ -492,7 +645,7 @@ namespace netxs::generics
         template<bool UseBack = faux>
         inline void undock_front()
         {
-            auto& item = front();
+            auto& item = buff[head];
             if constexpr (UseUndock)
             {
                 if constexpr (UseBack) undock_base_back (item);
@@ -504,7 +657,7 @@ namespace netxs::generics
         }
         inline void undock_back()
         {
-            auto& item = back();
+            auto& item = buff[tail];
             if constexpr (UseUndock) undock_base_back(item);
             item = type{};
             if (cart == tail) dec(tail), cart = tail;
@@ -533,7 +686,7 @@ namespace netxs::generics
                 auto it_2 = it_1 + d;
                 if (full())
                 {
-                    auto& item = front();
+                    auto& item = buff[head];
                     if constexpr (UseUndock) undock_base_front(item);
                     item = type(std::forward<Args>(args)...);
                     ++it_1;
@@ -542,7 +695,7 @@ namespace netxs::generics
                 {
                     ++size;
                     dec(head);
-                    auto& item = front();
+                    auto& item = buff[head];
                     item = type(std::forward<Args>(args)...);
                 }
                 swap_block<true>(it_1, it_2, begin());
@@ -557,7 +710,7 @@ namespace netxs::generics
                 auto it_2 = it_1 - d;
                 if (full())
                 {
-                    auto& item = front();
+                    auto& item = buff[head];
                     if constexpr (UseUndock) undock_base_front(item);
                     item = type{};
                     if (cart == head) inc(head), cart = head;
@@ -565,7 +718,7 @@ namespace netxs::generics
                 }
                 else ++size;
                 inc(tail);
-                back() = type(std::forward<Args>(args)...);
+                buff[tail] = type(std::forward<Args>(args)...);
                 swap_block<faux>(it_1, it_2, end() - 1);
                 ++it_2;
                 return it_2;
@@ -579,7 +732,7 @@ namespace netxs::generics
             if (full()) undock_front();
             else        ++size;
             inc(tail);
-            auto& item = back();
+            auto& item = buff[tail];
             item = type(std::forward<Args>(args)...);
             return item;
         }
@@ -589,7 +742,7 @@ namespace netxs::generics
             if (full()) undock_back();
             else        ++size;
             dec(head);
-            auto& item = front();
+            auto& item = buff[head];
             item = type(std::forward<Args>(args)...);
             return item;
         }
@@ -667,7 +820,7 @@ namespace netxs::generics
                         //todo optimize for !UseUndock
                         do
                         {
-                            if constexpr (UseUndock) undock_base_front(front());
+                            if constexpr (UseUndock) undock_base_front(buff[head]);
                             inc(head);
                         }
                         while (--size != new_size);
@@ -681,7 +834,7 @@ namespace netxs::generics
                         //todo optimize for !UseUndock
                         do
                         {
-                            if constexpr (UseUndock) undock_base_back(back());
+                            if constexpr (UseUndock) undock_base_back(buff[tail]);
                             dec(tail);
                         }
                         while (--size != new_size);
@@ -693,11 +846,12 @@ namespace netxs::generics
                 auto i = size;
                 while (i--)
                 {
-                    temp.emplace_back(std::move(front()));
+                    temp.emplace_back(std::move(buff[head]));
                     inc(head);
                 }
                 temp.resize(new_size);
                 std::swap(buff, temp);
+                epoch++;
                 peak = new_size;
                 head = 0;
                 tail = size ? size - 1 : peak - 1;
@@ -1527,6 +1527,12 @@ namespace netxs::input
                     hide();
                 }
             }
+            // tooltip: Return the moment the tooltip is going to be shown on idle timeout.
+            std::optional<time> pending() const
+            {
+                if (!canceled && !visible && current_sptr) return time_to_run;
+                else                                       return std::nullopt;
+            }
             auto check(time now) // Called every timer tick.
             {
                 if (changed_visibility)
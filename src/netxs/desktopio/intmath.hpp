@@ -31,6 +31,7 @@
 #include <numeric> // std::accumulate
 #include <optional>
 #include <span>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -1401,6 +1402,98 @@ namespace netxs
         }
     }
 
+    // intmath: Divide the boxblur row sums by the count (overloaded for the vectorizable sums).
+    template<class Accum_t, class Int_t>
+    void boxblur_quot(Accum_t const* accum, Accum_t* quot, Int_t w, auto count)
+    {
+        for (auto x = Int_t{}; x < w; x++) quot[x] = accum[x] / count;
+    }
+
+    // One-dimensional vertical boxblur that sweeps the whole row at once.
+    //
+    // Same result as boxblur1d along the Y axis, but the running sums are kept for all columns
+    // so that each step reads and writes contiguous rows instead of striding over the columns.
+    //
+    // Accum_t       Point accumulator type.
+    // InnerGlow     Using the top/bottom pixel value to approximate the image boundary.
+    // s_ptr         Source bitmap array pointer (columns are contiguous).
+    // d_ptr         Destination bitmap array pointer (columns are contiguous).
+    // w             Bitmap width.
+    // h             Bitmap height.
+    // r             Bokeh radius.
+    // s_dty         Index step along Y in the source.
+    // d_dty         Index step along Y in the destination.
+    // count         Divider of the resulting sums.
+    // P_Base s_ref  Lambda to convert the src pointer to the reference.
+    // P_Dest d_ref  Lambda to convert the dst pointer to the reference.
+    // PostFx shade  Lambda for postprocessing.
+    template<class Accum_t, bool InnerGlow,
+        class Src_t,
+        class Dst_t, class Int_t,
+        class P_Base, class P_Dest, class PostFx = noop>
+    void boxblur1v(Src_t s_ptr,
+                   Dst_t d_ptr, Int_t w,
+                                Int_t h, Int_t r, Int_t s_dty,
+                                                  Int_t d_dty, auto count,
+        P_Base s_ref, P_Dest d_ref, PostFx shade = {})
+    {
+        thread_local auto sums = std::vector<Accum_t>{};
+        auto r1 = r + 1;
+        sums.resize(w * 4);
+        auto accum = sums.data();
+        auto l_val = accum + w;
+        auto r_val = l_val + w;
+        auto quot  = r_val + w;
+        auto put = [&](auto d_cur)
+        {
+            boxblur_quot(accum, quot, w, count);
+            for (auto x = Int_t{}; x < w; x++)
+            {
+                d_ref(d_cur + x) = quot[x];
+                shade(*(d_cur + x));
+            }
+        };
+        auto sum = [&](auto s_cur, auto n)
+        {
+            std::fill(accum, accum + w, Accum_t{});
+            while (n--)
+            {
+                for (auto x = Int_t{}; x < w; x++) accum[x] += s_ref(s_cur + x);
+                s_cur += s_dty;
+            }
+        };
+        if (h <= r1) // All pixels on a column have the same average value.
+        {
+            sum(s_ptr, h);
+            auto width = r1 + r;
+            for (auto x = Int_t{}; x < w; x++) accum[x] = accum[x] * width / h;
+            for (auto y = Int_t{}; y < h; y++) put(d_ptr + y * d_dty);
+            return;
+        }
+        // Find the average on the bottom side.
+        sum(s_ptr + (h - r1) * s_dty, r1);
+        if constexpr (InnerGlow) for (auto x = Int_t{}; x < w; x++) r_val[x] = s_ref(s_ptr + (h - 1) * s_dty + x);
+        else                     for (auto x = Int_t{}; x < w; x++) r_val[x] = accum[x] / r1;
+        // Find the average on the top side.
+        sum(s_ptr, r1);
+        if constexpr (InnerGlow) for (auto x = Int_t{}; x < w; x++) l_val[x] = s_ref(s_ptr + x);
+        else                     for (auto x = Int_t{}; x < w; x++) l_val[x] = accum[x] / r1;
+        for (auto x = Int_t{}; x < w; x++) accum[x] += l_val[x] * r; // Topmost pixel values.
+        put(d_ptr);
+        for (auto y = Int_t{ 1 }; y < h; y++)
+        {
+            auto s_sub = y - r1;
+            auto s_add = y + r;
+            auto sub = s_ptr + std::max(Int_t{}, s_sub) * s_dty;
+            auto add = s_ptr + std::min(h - 1,   s_add) * s_dty;
+            if (s_sub >= 0 && s_add < h) for (auto x = Int_t{}; x < w; x++) { accum[x] -= s_ref(sub + x); accum[x] += s_ref(add + x); }
+            else if (s_add < h)          for (auto x = Int_t{}; x < w; x++) { accum[x] -= l_val[x];       accum[x] += s_ref(add + x); }
+            else if (s_sub >= 0)         for (auto x = Int_t{}; x < w; x++) { accum[x] -= s_ref(sub + x); accum[x] += r_val[x];       }
+            else                         for (auto x = Int_t{}; x < w; x++) { accum[x] -= l_val[x];       accum[x] += r_val[x];       }
+            put(d_ptr + y * d_dty);
+        }
+    }
+
     // intmath: Move block to the specified destination. If begin_it > end_it (exclusive) decrement is used.
     template<bool Fwd, class Src, class Dst, class P>
     void proc_block(Src begin_it, Src end_it, Dst dest_it, P proc)
@@ -1469,11 +1562,11 @@ namespace netxs
                                                        1, d_dty, count, s_ref,           //     auto w = [&]{ auto test = ui::face{};
                                                                         d_ref);          //                   test.size({ x, y });
         count *= ry + ry + 1;                                                            //                   auto start = datetime::now();
-        boxblur1d<Accum_t, InnerGlow, 1>(d_ptr,    // blur vertically and place          //                   test.blur(1);
-                                         s_ptr, h, // result back to the source (s_ptr)  //                   auto delta = datetime::now() - start;
-                                                w, ry, d_dty, 1,                         //                   std::cout << datetime::round<si32>(delta) << "ms\n"; };
-                                                       s_dty, 1, count, d_ref,           //     auto works = std::list<std::thread>{};
-                                                                        s_ref, shade);   //     while (t--) works.emplace_back(w);
+        boxblur1v<Accum_t, InnerGlow>(d_ptr,       // blur vertically and place          //                   test.blur(1);
+                                      s_ptr, w,    // result back to the source (s_ptr)  //                   auto delta = datetime::now() - start;
+                                             h, ry, d_dty,                               //                   std::cout << datetime::round<si32>(delta) << "ms\n"; };
+                                                    s_dty, count, d_ref,                 //     auto works = std::list<std::thread>{};
+                                                                  s_ref, shade);         //     while (t--) works.emplace_back(w);
         }                                                                                //     for (auto& t : works) t.join();
     }
 }
\ No newline at end of file
@@ -76,21 +76,24 @@ namespace netxs::datetime
     {
         using cond = std::condition_variable;
         using work = std::thread;
+        using mark = std::atomic<time>;
 
-        T&   owner;
-        flag alive;
-        flag letup;
-        span delay;
-        span watch;
-        span pulse;
-        work fiber;
-        cond synch;
+        static constexpr auto idle = span{ 1s }; // quartz: The longest sleep of an idle timer.
+
+        T&    owner;
+        flag  alive;
+        flag  letup;
+        flag  fresh; // quartz: The scene has changed since the last tick.
+        mark  alarm; // quartz: The nearest deadline requested for the next tick.
+        span  delay;
+        span  watch;
+        span  pulse;
+        work  fiber;
+        cond  synch;
+        std::mutex mutex;
 
         void worker()
         {
-            auto mutex = std::mutex{};
-            auto guard = std::unique_lock{ mutex };
-
             auto now = datetime::now();
             auto prior = now;
 
@@ -100,17 +103,24 @@ namespace netxs::datetime
                 prior =  now;
 
                 now = datetime::now();
+                alarm = time::max(); // Deadline listeners renew their deadlines during the tick.
                 owner.timer(now);
 
+                auto guard = std::unique_lock{ mutex };
                 if (letup.exchange(faux))
                 {
-                    synch.wait_for(guard, delay);
+                    synch.wait_for(guard, delay, [&]{ return !alive; });
                     delay = span::zero();
                 }
-                else
+                else if (fresh.exchange(faux)) // Keep the frame rate while something is changing.
                 {
                     auto trail = pulse - now.time_since_epoch() % pulse;
-                    synch.wait_for(guard, trail);
+                    synch.wait_for(guard, trail, [&]{ return !alive; });
+                }
+                else // Sleep until the nearest deadline or the next change.
+                {
+                    auto until = std::min(alarm.load(), now + std::max(pulse, idle));
+                    synch.wait_until(guard, until, [&]{ return fresh || !alive || alarm.load() < until; });
                 }
             }
         }
@@ -120,6 +130,8 @@ namespace netxs::datetime
             : owner{ owner        },
               alive{ faux         },
               letup{ faux         },
+              fresh{ true         },
+              alarm{ time::max()  },
               delay{ span::zero() },
               watch{ span::zero() },
               pulse{ span::max()  }
@@ -146,6 +158,29 @@ namespace netxs::datetime
             delay = pause2;
             letup = true;
         }
+        // quartz: Request the next tick at the frame rate.
+        void wake()
+        {
+            if (!fresh.exchange(true))
+            {
+                auto guard = std::lock_guard{ mutex };
+                synch.notify_one();
+            }
+        }
+        // quartz: Request a tick not later than the specified moment.
+        void expect(time deadline)
+        {
+            auto prior = alarm.load();
+            while (deadline < prior)
+            {
+                if (alarm.compare_exchange_weak(prior, deadline))
+                {
+                    auto guard = std::lock_guard{ mutex };
+                    synch.notify_one();
+                    break;
+                }
+            }
+        }
         bool stopwatch(span p)
         {
             if (watch > p)
@@ -162,7 +197,10 @@ namespace netxs::datetime
         {
             if (alive.exchange(faux))
             {
-                synch.notify_all();
+                {
+                    auto guard = std::lock_guard{ mutex };
+                    synch.notify_all();
+                }
                 if (fiber.joinable())
                 {
                     fiber.join();
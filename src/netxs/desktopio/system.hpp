@@ -49,6 +49,10 @@
 
     #include <sys/types.h>
     #include <sys/stat.h>   // ::chmod()
+    #include <sys/mman.h>   // ::mmap()
+    #include <poll.h>       // ::poll()
+    #include <sys/uio.h>    // ::writev()
+    #include <limits.h>     // IOV_MAX
     #include <fcntl.h>      // ::splice()
 
     #if defined(__linux__)
@@ -1494,15 +1498,9 @@ namespace netxs::os
             auto wait(span timeout = {})
             {
                 using namespace std::chrono;
-                auto s = datetime::round<decltype(::timeval::tv_sec), seconds>(timeout);
-                auto m = datetime::round<decltype(::timeval::tv_usec), microseconds>(timeout - seconds{ s });
-                auto v = ::timeval{ .tv_sec = s, .tv_usec = m };
-                auto t = timeout != span{} ? &v : nullptr /*infinite*/;
-                auto socks = fd_set{};
-                FD_ZERO(&socks);
-                FD_SET(h[0], &socks);
-                auto nfds = 1 + h[0];
-                auto fired = ::select(nfds, &socks, 0, 0, t);
+                auto t = timeout != span{} ? std::max(1, (si32)ceil<milliseconds>(timeout).count()) : -1 /*infinite*/;
+                auto socks = ::pollfd{ .fd = h[0], .events = POLLIN };
+                auto fired = ::poll(&socks, 1, t);
                 return fired;
             }
 
@@ -1709,6 +1707,42 @@ namespace netxs::os
         {
             return io::send(os::stdout_fd, buffer);
         }
+        // io: Write the blocks in order as a single gather write (without concatenating them).
+        auto send(fd_t fd, std::span<view const> list)
+        {
+            #if defined(_WIN32)
+                for (auto block : list)
+                {
+                    if (block.size() && !io::send(fd, block)) return faux;
+                }
+                return true;
+            #else
+                static constexpr auto limit = std::min(64, IOV_MAX);
+                auto iovs = std::array<::iovec, limit>{};
+                auto head = list.begin();
+                auto tail = list.end();
+                auto skip = 0_sz; // Bytes of the head block already written.
+                while (true)
+                {
+                    auto count = 0;
+                    for (auto iter = head; iter != tail && count < limit; ++iter)
+                    {
+                        auto block = iter == head ? iter->substr(skip) : *iter;
+                        if (block.size()) iovs[count++] = { .iov_base = (void*)block.data(), .iov_len = block.size() };
+                    }
+                    if (count == 0) return true;
+                    auto n = ::writev(fd, iovs.data(), count);
+                    if (n <= 0) return faux;
+                    while (head != tail && std::cmp_greater_equal(n, head->size() - skip))
+                    {
+                        n -= head->size() - skip;
+                        skip = 0;
+                        ++head;
+                    }
+                    skip += n;
+                }
+            #endif
+        }
         template<class ...Args>
         auto recv(sock& handle, Args&&... args)
         {
@@ -1722,25 +1756,26 @@ namespace netxs::os
 
         namespace
         {
+            template<class A, size_t... I>
+            constexpr auto _repack(fd_t h, A const& a, std::index_sequence<I...>)
+            {
+                return std::array{ a[I]..., h };
+            }
+            template<size_t N, class P, class Index = std::make_index_sequence<N>, class ...Args>
+            constexpr auto _combine(std::array<fd_t, N> const& a, fd_t h, P&& /*proc*/, Args&&... args)
+            {
+                if constexpr (sizeof...(args)) return _combine(_repack(h, a, Index{}), std::forward<Args>(args)...);
+                else                           return _repack(h, a, Index{});
+            }
+            template<class P, class ...Args>
+            constexpr auto _fd_set(fd_t handle, P&& /*proc*/, Args&&... args)
+            {
+                if constexpr (sizeof...(args)) return _combine(std::array{ handle }, std::forward<Args>(args)...);
+                else                           return std::array{ handle };
+            }
+
             #if defined(_WIN32)
 
-                template<class A, sz_t... I>
-                constexpr auto _repack(fd_t h, A const& a, std::index_sequence<I...>)
-                {
-                    return std::array{ a[I]..., h };
-                }
-                template<sz_t N, class P, class Index = std::make_index_sequence<N>, class ...Args>
-                constexpr auto _combine(std::array<fd_t, N> const& a, fd_t h, P&& proc, Args&&... args)
-                {
-                    if constexpr (sizeof...(args)) return _combine(_repack(h, a, Index{}), std::forward<Args>(args)...);
-                    else                           return _repack(h, a, Index{});
-                }
-                template<class P, class ...Args>
-                constexpr auto _fd_set(fd_t handle, P&& /*proc*/, Args&&... args)
-                {
-                    if constexpr (sizeof...(args)) return _combine(std::array{ handle }, std::forward<Args>(args)...);
-                    else                           return std::array{ handle };
-                }
                 template<class R, class P, class ...Args>
                 constexpr auto _handle(R i, fd_t /*handle*/, P&& proc, Args&&... args)
                 {
@@ -1758,31 +1793,18 @@ namespace netxs::os
 
             #else
 
-                template<class P, class ...Args>
-                auto _fd_set(fd_set& socks, fd_t handle, P&& /*proc*/, Args&&... args)
-                {
-                    if (handle != os::invalid_fd) FD_SET(handle, &socks);
-                    if constexpr (sizeof...(args))
-                    {
-                        return std::max(handle, _fd_set(socks, std::forward<Args>(args)...));
-                    }
-                    else
-                    {
-                        return handle;
-                    }
-                }
                 template<class T, class P, class ...Args>
-                auto _select(T count, fd_set& socks, fd_t handle, P&& proc, Args&&... args)
+                auto _select(T count, ::pollfd* socks, fd_t /*handle*/, P&& proc, Args&&... args)
                 {
                     if (count > 0)
                     {
-                        if (handle != os::invalid_fd && FD_ISSET(handle, &socks))
+                        if (socks->revents & (POLLIN | POLLHUP | POLLERR)) // Negative descriptors are ignored by ::poll().
                         {
                             proc();
                             count--;
                         }
-                        // Multiple descriptors can be ready in a single ::select() iteration.
-                        if constexpr (sizeof...(args)) _select(count, socks, std::forward<Args>(args)...);
+                        // Multiple descriptors can be ready in a single ::poll() iteration.
+                        if constexpr (sizeof...(args)) _select(count, ++socks, std::forward<Args>(args)...);
                     }
                 }
 
@@ -1802,13 +1824,15 @@ namespace netxs::os
 
             #else
 
-                auto timeval = ::timeval{ .tv_sec = 0, .tv_usec = 0 };
-                auto timeout = NonBlocked ? &timeval/*returns immediately*/ : nullptr;
-                auto socks = fd_set{};
-                FD_ZERO(&socks);
-                auto nfds = 1 + _fd_set(socks, std::forward<Args>(args)...);
-                auto count = ::select(nfds, &socks, 0, 0, timeout);
-                _select(count, socks, std::forward<Args>(args)...);
+                static constexpr auto timeout = NonBlocked ? 0 /*returns immediately*/ : -1 /*infinite*/;
+                auto handles = _fd_set(std::forward<Args>(args)...);
+                auto socks = std::array<::pollfd, handles.size()>{};
+                for (auto i = 0_sz; i < handles.size(); i++)
+                {
+                    socks[i] = { .fd = handles[i], .events = POLLIN }; // There is no FD_SETSIZE limit on the descriptor value.
+                }
+                auto count = ::poll(socks.data(), (nfds_t)socks.size(), timeout);
+                _select(count, socks.data(), std::forward<Args>(args)...);
 
             #endif
         }
@@ -1827,6 +1851,58 @@ namespace netxs::os
                 }
             #endif
         }
+        // os::io: Memory block backed by an anonymous temporary file (the file is gone when the block is released).
+        struct page
+        {
+            byte* memory{};
+            sz_t  length{};
+            #if defined(_WIN32)
+            fd_t  mapped{ os::invalid_fd };
+            #endif
+            fd_t  handle{ os::invalid_fd };
+
+            page(page const&) = delete;
+            page(sz_t size)
+            {
+                #if defined(_WIN32)
+
+                    auto tmpdir = wide(MAX_PATH + 1, L'\0');
+                    auto tmpfil = wide(MAX_PATH + 1, L'\0');
+                    tmpdir.resize(::GetTempPathW((DWORD)tmpdir.size(), tmpdir.data()));
+                    if (tmpdir.empty() || !::GetTempFileNameW(tmpdir.c_str(), L"vtm", 0, tmpfil.data())) return;
+                    handle = ::CreateFileW(tmpfil.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+                    if (handle == os::invalid_fd) return;
+                    mapped = ::CreateFileMappingW(handle, nullptr, PAGE_READWRITE, (DWORD)((ui64)size >> 32), (DWORD)size, nullptr);
+                    if (!mapped) { mapped = os::invalid_fd; return; }
+                    memory = (byte*)::MapViewOfFile(mapped, FILE_MAP_ALL_ACCESS, 0, 0, size);
+
+                #else
+
+                    auto errcod = std::error_code{};
+                    auto tmpdir = os::fs::temp_directory_path(errcod);
+                    auto tmpfil = ((errcod ? os::fs::path{ "/tmp" } : tmpdir) / "vtm-XXXXXX").string();
+                    handle = ::mkstemp(tmpfil.data());
+                    if (handle == os::invalid_fd) return;
+                    ::unlink(tmpfil.c_str());
+                    if (::ftruncate(handle, (off_t)size) != 0) return;
+                    auto ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+                    if (ptr != MAP_FAILED) memory = (byte*)ptr;
+
+                #endif
+                if (memory) length = size;
+            }
+            ~page()
+            {
+                #if defined(_WIN32)
+                    if (memory) ::UnmapViewOfFile(memory);
+                    os::close(mapped);
+                #else
+                    if (memory) ::munmap(memory, length);
+                #endif
+                os::close(handle);
+            }
+            explicit operator bool () const { return memory; }
+        };
     }
 
     namespace env
@@ -3132,6 +3208,11 @@ namespace netxs::os
                 pipe::isbusy = faux; // io::send blocks until the send is complete.
                 return io::send(handle.w, buff);
             }
+            virtual bool send(std::span<view const> list) override
+            {
+                pipe::isbusy = faux; // io::send blocks until the send is complete.
+                return io::send(handle.w, list);
+            }
             virtual qiew recv(char* buff, size_t size) override
             {
                 auto result = qiew{};
@@ -4277,16 +4358,17 @@ namespace netxs::os
                 }
                 if constexpr (debugmode) log(prompt::dtvt, "Destructor complete");
             }
-            void writer()
+            void writer(view config)
             {
                 if constexpr (debugmode) log(prompt::dtvt, "Writing thread started", ' ', utf::to_hex_0x(std::this_thread::get_id()));
                 auto cache = text{};
                 auto guard = std::unique_lock{ writemtx };
-                while ((void)writesyn.wait(guard, [&]{ return writebuf.size() || !attached; }), attached)
+                while ((void)writesyn.wait(guard, [&]{ return writebuf.size() || config.size() || !attached; }), attached)
                 {
                     std::swap(cache, writebuf);
                     guard.unlock();
-                    if (termlink.send(cache)) cache.clear();
+                    auto list = std::array{ std::exchange(config, {}), view{ cache } }; // The config goes ahead of the pending input.
+                    if (termlink.send(list)) cache.clear();
                     else
                     {
                         if constexpr (debugmode) log(prompt::dtvt, "Unexpected disconnection");
@@ -4304,11 +4386,6 @@ namespace netxs::os
                     auto [s_pipe_r, m_pipe_w] = os::ipc::newpipe();
                     auto [m_pipe_r, s_pipe_w] = os::ipc::newpipe();
                     io::send(m_pipe_w, directvt::binary::marker{ config.size(), initsize });
-                    if (config.size())
-                    {
-                        auto guard = std::lock_guard{ writemtx };
-                        writebuf = config + writebuf;
-                    }
                     termlink = ipc::stdcon{ m_pipe_r, m_pipe_w };
 
                     auto cmd = connect(ptr::shared<sock>(s_pipe_r, s_pipe_w));
@@ -4320,7 +4397,7 @@ namespace netxs::os
                         clientfd = m_pipe_w;
                         if constexpr (debugmode) log("%%DirectVT Gateway created for process '%cmd%'", prompt::dtvt, ansi::hi(utf::debase437(cmd)));
                         writesyn.notify_one(); // Flush temp buffer.
-                        auto stdwrite = std::thread{ [&]{ writer(); } };
+                        auto stdwrite = std::thread{ [&]{ writer(config); } };
 
                         if constexpr (debugmode) log(prompt::dtvt, "Reading thread started", ' ', utf::to_hex_0x(std::this_thread::get_id()));
                         directvt::binary::stream::reading_loop(termlink, receiver);
@@ -72,6 +72,7 @@ namespace netxs::ui
             X(KeyEvent             ) /* */ \
             X(ExclusiveKeyboardMode) /* */ \
             X(FindNextMatch        ) /* */ \
+            X(CountMatches         ) /* */ \
             X(ScrollViewportByPage ) /* */ \
             X(ScrollViewportByCell ) /* */ \
             X(ScrollViewportToTop  ) /* */ \
@@ -230,6 +231,9 @@ namespace netxs::ui
             si32 def_find_f;
 
             bool def_alt_on;
+            bool def_packed;
+            bool def_spills;
+            bool def_lookup;
 
             text send_input;
 
@@ -271,6 +275,9 @@ namespace netxs::ui
                 resetonkey =             config.settings::take("/config/terminal/scrollback/reset/onkey",     true);
                 resetonout =             config.settings::take("/config/terminal/scrollback/reset/onoutput",  faux);
                 def_alt_on =             config.settings::take("/config/terminal/scrollback/altscroll",       true);
+                def_packed =             config.settings::take("/config/terminal/scrollback/compact",         faux);
+                def_spills =             config.settings::take("/config/terminal/scrollback/compact/spill",   faux);
+                def_lookup =             config.settings::take("/config/terminal/scrollback/index",           faux);
                 def_lucent = std::max(0, config.settings::take("/config/terminal/scrollback/oversize/opacity",si32{ 0xC0 } ));
                 def_margin = std::max(0, config.settings::take("/config/terminal/scrollback/oversize",        si32{ 0 }    ));
                 def_tablen = std::max(1, config.settings::take("/config/terminal/tablen",                     si32{ 8 }    ));
@@ -1092,10 +1099,21 @@ namespace netxs::ui
                 using rich::rich;
                 using type = deco::type;
                 using id_t = ui32;
+                using pack = std::vector<byte>;
+                using prop = std::array<byte, 24>;
+
+                struct slot
+                {
+                    netxs::sptr<os::io::page> page{}; // slot: Disk-backed page.
+                    ui32                      from{}; // slot: Packed cells offset in the page.
+                    ui32                      size{}; // slot: Packed cells size.
+                };
 
                 line(line&& l)
                     : rich { std::forward<rich>(l) },
-                      index{ l.index }
+                      index{ l.index },
+                      frost{ std::move(l.frost) },
+                      paged{ std::move(l.paged) }
                 {
                     style = l.style;
                     _size = l._size;
@@ -1106,7 +1124,9 @@ namespace netxs::ui
                 line(line const& l)
                     : rich{ l       },
                      index{ l.index },
-                     style{ l.style }
+                     style{ l.style },
+                     frost{ l.frost },
+                     paged{ l.paged }
                 { }
                 line(id_t line_id, deco const& line_style, span dt, twod sz)
                     : rich{ dt, sz     },
@@ -1137,6 +1157,8 @@ namespace netxs::ui
                 deco style{};
                 si32 _size{};
                 type _kind{};
+                pack frost{}; // line: Packed cells. The canvas is empty while it is not.
+                slot paged{}; // line: Packed cells swapped out to disk. The canvas and frost are empty while it is set.
 
                 friend void swap(line& lhs, line& rhs)
                 {
@@ -1145,13 +1167,100 @@ namespace netxs::ui
                     std::swap(lhs.style, rhs.style);
                     std::swap(lhs._size, rhs._size);
                     std::swap(lhs._kind, rhs._kind);
+                    std::swap(lhs.frost, rhs.frost);
+                    std::swap(lhs.paged, rhs.paged);
                 }
                 void wipe()
                 {
                     rich::kill();
+                    frost = {};
+                    paged = {};
                     _size = {};
                     _kind = {};
                 }
+                // line: Pack cells into a per-line palette of attributes (colors, style, link, bitmap) plus byte indices and a glyph column.
+                //       Glyph tokens are stored in two bytes if possible. Lines with more than 256 distinct attributes are not packed.
+                void freeze()
+                {
+                    static_assert(sizeof(cell) == 32 && offsetof(cell, gc) == 8 && sizeof(cell::gc) == 8); // Cell layout: uv(8) gc(8) st(8) id(4) px(4).
+                    if (frost.size() || canvas.empty()) return;
+                    auto attrs = std::vector<prop>{};
+                    auto links = pack(canvas.size());
+                    auto gsize = sz_t{ 2 };
+                    auto probe = prop{};
+                    auto found = sz_t{};
+                    for (auto i = sz_t{}; i < canvas.size(); i++)
+                    {
+                        auto src = (byte const*)&canvas[i];
+                        std::memcpy(probe.data() + 0, src +  0,  8);
+                        std::memcpy(probe.data() + 8, src + 16, 16);
+                        if (found == attrs.size() || attrs[found] != probe)
+                        {
+                            found = std::find(attrs.begin(), attrs.end(), probe) - attrs.begin();
+                            if (found == attrs.size())
+                            {
+                                if (found == 256) return; // Too colorful to pack.
+                                attrs.push_back(probe);
+                            }
+                        }
+                        links[i] = (byte)found;
+                        if (gsize == 2 && std::any_of(src + 10, src + 16, [](byte b){ return b != 0; }))
+                        {
+                            gsize = 8;
+                        }
+                    }
+                    frost.reserve(2 + attrs.size() * sizeof(prop) + links.size() * (1 + gsize));
+                    frost.push_back((byte)gsize);
+                    frost.push_back((byte)(attrs.size() - 1));
+                    for (auto& a : attrs) frost.insert(frost.end(), a.begin(), a.end());
+                    frost.insert(frost.end(), links.begin(), links.end());
+                    for (auto& c : canvas)
+                    {
+                        auto src = (byte const*)&c + 8;
+                        frost.insert(frost.end(), src, src + gsize);
+                    }
+                    canvas = {};
+                }
+                // line: Unpack cells. It is called on every mutable access through the scrollback ring, so the packing is transparent to line users.
+                void thaw()
+                {
+                    if (frost.empty() && !paged.page) return;
+                    if (paged.page)
+                    {
+                        auto head = paged.page->memory + paged.from;
+                        frost.assign(head, head + paged.size);
+                        paged = {};
+                    }
+                    auto gsize = (sz_t)frost[0];
+                    auto attrs = frost.data() + 2;
+                    auto links = attrs + (frost[1] + 1) * sizeof(prop);
+                    auto count = (sz_t)(frost.data() + frost.size() - links) / (1 + gsize);
+                    auto glyph = links + count;
+                    canvas.resize(count);
+                    for (auto i = sz_t{}; i < count; i++)
+                    {
+                        auto dst = (byte*)&canvas[i];
+                        auto src = attrs + links[i] * sizeof(prop);
+                        std::memcpy(dst +  0, src + 0, 8);
+                        std::memcpy(dst + 16, src + 8, 16);
+                        std::memset(dst +  8, 0, 8);
+                        std::memcpy(dst +  8, glyph + i * gsize, gsize);
+                    }
+                    frost = {};
+                }
+                // line: Return the line as is if it is not packed, otherwise unpack it into the scratch line and return the scratch.
+                line const& thawed(line& scratch) const
+                {
+                    if (frost.empty() && !paged.page) return *this;
+                    scratch = *this;
+                    scratch.thaw();
+                    return scratch;
+                }
+                // line: Swap packed cells out to disk.
+                void spill(auto& depot)
+                {
+                    if (frost.size() && depot.put(frost, paged)) frost = {};
+                }
                 bool wrapped() const
                 {
                     assert(_kind == style.get_kind());
@@ -1240,6 +1349,7 @@ namespace netxs::ui
             virtual void selection_status(term_state& status) const       = 0;
             virtual twod selection_gonext(feed direction)                 = 0;
             virtual twod selection_gofind(feed direction, view data = {}) = 0;
+            virtual si32 selection_tally()                                = 0;
             virtual twod selection_search(feed direction, view data = {})
             {
                 auto delta = dot_00;
@@ -2330,6 +2440,19 @@ namespace netxs::ui
                 return direction == feed::fwd ? find(match.length(), 2, uifwd, uirev)
                                               : find(0, match.length(), uirev, uifwd);
             }
+            // bufferbase: Return the number of matches in the specified canvas.
+            auto selection_tally(rich const& canvas)
+            {
+                auto count = si32{};
+                auto offset = si32{};
+                if (match.length())
+                while (canvas.find(match, offset))
+                {
+                    offset += match.length();
+                    count++;
+                }
+                return count;
+            }
             // bufferbase: Return match navigation state.
     virtual si32 selection_button(twod /*delta*/ = {})
             {
@@ -2952,6 +3075,11 @@ namespace netxs::ui
                 bufferbase::selection_update(faux);
                 return dot_00;
             }
+            // alt_screen: Return the number of matches on the screen.
+            si32 selection_tally() override
+            {
+                return bufferbase::selection_tally(canvas);
+            }
             // alt_screen: Cancel text selection.
             bool selection_cancel() override
             {
@@ -3011,6 +3139,7 @@ namespace netxs::ui
                 using ring::ring;
                 using type = line::type;
                 using maps = std::map<si32, si32>[type::count];
+                using hsum = generics::fenwick<si32>;
 
                 si32 caret{}; // buff: Current line cursor horizontal position.
                 si32 vsize{}; // buff: Scrollback vertical size (height).
@@ -3022,7 +3151,68 @@ namespace netxs::ui
                 si32 ancdy{}; // buff: Slide's top line offset.
                 bool round{}; // buff: Is the slide position approximate.
                 bool rolls{}; // buff: The scrollback buffer ring was scrolled.
+                si32 sweep{}; // buff: Next position to repack.
+                hsum hsums{}; // buff: Prefix sums of line heights by ring slot.
+                std::vector<si32> hlist{}; // buff: Line heights by ring slot.
+                si32 hseal{ -1 }; // buff: Ring epoch the height index is valid for (-1 if not valid).
+                si32 taint{ si32max }; // buff: Top position of the lines whose ids were rewritten since the last text index sync.
 
+                // buff: Return the line height at the current width.
+                auto get_height(type line_kind, si32 line_size) const
+                {
+                    return line_size > width && line_kind == type::autowrap ? (line_size + width - 1) / width
+                                                                            : 1;
+                }
+                // buff: Update the height index for the specified line if it resides in the ring.
+                void retain(line const& l, si32 height)
+                {
+                    if (hseal != ring::epoch) return;
+                    auto slot = &l - ring::buff.data();
+                    if (slot >= 0 && slot < ring::peak)
+                    {
+                        auto& h = hlist[slot];
+                        hsums.add((si32)slot, height - h);
+                        h = height;
+                    }
+                }
+                // buff: Drop the height index. It is rebuilt on demand.
+                void forget()
+                {
+                    hseal = -1;
+                }
+                // buff: Rebuild the height index if it is not valid. It doesn't unpack lines.
+                void census()
+                {
+                    if (hseal == ring::epoch && hsums.sum(ring::peak) == vsize) return;
+                    hlist.assign(ring::peak, 0);
+                    for (auto i = 0; i < ring::size; i++)
+                    {
+                        auto& l = ring::peek(i);
+                        hlist[ring::mod(ring::head + i)] = get_height(l._kind, l._size);
+                    }
+                    hsums.reset(hlist);
+                    hseal = ring::epoch;
+                }
+                // buff: Return the vertical position of the line at the specified position in O(log n).
+                auto vtpos(si32 at)
+                {
+                    census();
+                    auto a = ring::head;
+                    auto b = a + at;
+                    return b <= ring::peak ? hsums.sum(b) - hsums.sum(a)
+                                           : hsums.sum(ring::peak) - hsums.sum(a) + hsums.sum(b - ring::peak);
+                }
+                // buff: Return the position of the line covering the specified vertical position (0 <= vpos < vsize) and the offset inside the line in O(log n).
+                auto vtfind(si32 vpos)
+                {
+                    census();
+                    auto base = hsums.sum(ring::head);
+                    auto rest = hsums.sum(ring::peak) - base;
+                    auto slot = vpos < rest ? hsums.find(base + vpos)
+                                            : hsums.find(vpos - rest);
+                    auto at = std::clamp(ring::dst(ring::head, slot), 0, ring::size - 1);
+                    return std::pair{ at, vpos - vtpos(at) };
+                }
                 // buff: Decrease height.
                 void dec_height(si32& block_vsize, type line_kind, si32 line_size)
                 {
@@ -3047,6 +3237,7 @@ namespace netxs::ui
                 {
                     vsize = 0;
                     width = std::max(1, new_width);
+                    forget();
                     for (auto kind : { type::leftside,
                                        type::rghtside,
                                        type::centered })
@@ -3110,6 +3301,7 @@ namespace netxs::ui
                 void invite(line& l)
                 {
                     invite(l._kind, l._size, l.style.get_kind(), l.length());
+                    retain(l, get_height(l._kind, l._size));
                 }
                 // buff: Push a new line back.
                 template<class ...Args>
@@ -3117,6 +3309,7 @@ namespace netxs::ui
                 {
                     auto& l = ring::push_back(std::forward<Args>(args)...);
                     invite(l._kind, l._size, l.style.get_kind(), l.length());
+                    retain(l, get_height(l._kind, l._size));
                     return l;
                 }
                 // buff: Insert a new line at the specified position.
@@ -3125,6 +3318,8 @@ namespace netxs::ui
                 {
                     auto& l = *ring::insert(at, std::forward<Args>(args)...);
                     invite(l._kind, l._size, l.style.get_kind(), l.length());
+                    forget();
+                    taint = std::min(taint, at);
                     return l;
                 }
                 // buff: Remove specified line info from accounting and update metrics based on scroll height.
@@ -3133,6 +3328,7 @@ namespace netxs::ui
                     auto line_kind = l._kind;
                     auto line_size = l._size;
                     undock(line_kind, line_size);
+                    retain(l, 0);
                     dec_height(basis, line_kind, line_size);
                     dec_height(slide, line_kind, line_size);
                     if (basis < 0)
@@ -3148,13 +3344,13 @@ namespace netxs::ui
                     rolls = true;
                 }
                 // buff: Remove information about the specified line from accounting.
-                void undock_base_back(line& l) override { undock(l._kind, l._size); }
+                void undock_base_back(line& l) override { undock(l._kind, l._size); retain(l, 0); }
                 // buff: Return the item position in the scrollback using its id.
                 auto index_by_id(ui32 item_id) const
                 {
                     //No need to disturb distant objects, it may already be in the swap.
                     auto total = length();
-                    return (si32)(total - 1 - (back().index - item_id)); // ring buffer size is never larger than max_int32.
+                    return (si32)(total - 1 - (ring::peek(total - 1).index - item_id)); // ring buffer size is never larger than max_int32.
                 }
                 // buff: Return an iterator pointing to the item with the specified id.
                 auto iter_by_id(ui32 line_id) -> ring::iter<ring> //todo MSVC 17.7.0 requires return type
@@ -3170,18 +3366,20 @@ namespace netxs::ui
                 void recalc(line& l)
                 {
                     recalc(l._kind, l._size, l.style.get_kind(), l.length());
+                    retain(l, get_height(l._kind, l._size));
                 }
                 // buff: Rewrite the indices from the specified position to the end or to the top (negative from).
                 void reindex(si32 from)
                 {
+                    taint = from >= 0 ? std::min(taint, from) : 0;
                     if (from >= 0)
                     {
                         auto a = begin() + from;
                         auto b = end();
-                        auto i = from == 0 ? 0 : (a - 1)->index + 1;
+                        auto i = from == 0 ? 0 : (a - 1).peek().index + 1;
                         while (a != b)
                         {
-                            a->index = i++;
+                            a.peek().index = i++;
                             ++a;
                         }
                     }
@@ -3189,10 +3387,10 @@ namespace netxs::ui
                     {
                         auto a = begin();
                         auto b = a + std::abs(from);
-                        auto i = b->index - std::abs(from);
+                        auto i = b.peek().index - std::abs(from);
                         while (a != b)
                         {
-                            a->index = i++;
+                            a.peek().index = i++;
                             ++a;
                         }
                     }
@@ -3202,6 +3400,7 @@ namespace netxs::ui
                 {
                     amount = ring::remove(at, amount);
                     reindex(at);
+                    forget();
                     return amount;
                 }
                 // buff: Clear scrollback, add one empty line, and reset all metrics.
@@ -3209,6 +3408,7 @@ namespace netxs::ui
                 {
                     auto auto_wrap = current().wrapped();
                     ring::clear();
+                    taint = 0;
                     caret = 0;
                     basis = 0;
                     slide = 0;
@@ -3223,6 +3423,7 @@ namespace netxs::ui
                     auto backup = current();
                     backup.index = 0;
                     ring::clear();
+                    taint = 0;
                     auto& curln = ring::push_back(backup); // Keep current line.
                     basis = 0;
                     slide = 0;
@@ -3233,6 +3434,117 @@ namespace netxs::ui
                 }
             };
 
+            struct depot // scroll_buf: Disk-backed storage for packed lines. Pages are released along with the last line referencing them.
+            {
+                static constexpr auto page_size = sz_t{ 16 * 1024 * 1024 };
+
+                netxs::sptr<os::io::page> page{}; // depot: Current page.
+                sz_t                      used{}; // depot: Current page fill.
+                bool                      fail{}; // depot: Temporary file is not available.
+
+                auto put(line::pack const& data, line::slot& dest)
+                {
+                    if (fail) return faux;
+                    if (!page || used + data.size() > page->length)
+                    {
+                        page = ptr::shared<os::io::page>(std::max(page_size, (sz_t)data.size()));
+                        used = 0;
+                        if (!*page)
+                        {
+                            log(prompt::term, "Failed to create a scrollback swap file", ' ', os::error());
+                            page.reset();
+                            fail = true;
+                            return faux;
+                        }
+                    }
+                    std::copy(data.begin(), data.end(), page->memory + used);
+                    dest = { page, (ui32)used, (ui32)data.size() };
+                    used += data.size();
+                    return true;
+                }
+            };
+
+            struct sieve // scroll_buf: UTF-8 shadow of the lines far above the viewport. The text search leaps over the lines that don't contain the match without unpacking them.
+            {
+                text                utf8{}; // sieve: Line texts, each followed by '\n'.
+                std::vector<size_t> edges{}; // sieve: Line text offsets.
+                size_t              front{}; // sieve: Number of the dropped offsets at the head of edges.
+                id_t                first{}; // sieve: Id of the first indexed line.
+
+                auto size() const               { return (id_t)(edges.size() - front); }
+                auto next() const               { return first + size();               } // sieve: Id of the line following the last indexed line.
+                auto holds(id_t line_id) const  { return line_id - first < size();     }
+                void clear()
+                {
+                    utf8.clear();
+                    edges.clear();
+                    front = 0;
+                }
+                void reset(id_t line_id)
+                {
+                    clear();
+                    first = line_id;
+                }
+                // sieve: Append the line text.
+                void push(line& l)
+                {
+                    edges.push_back(utf8.size());
+                    l.utf8(utf8);
+                    utf8.push_back('\n');
+                }
+                // sieve: Drop the lines preceding the specified line.
+                void pop_front(id_t line_id)
+                {
+                    if (!holds(line_id)) return;
+                    front += line_id - first;
+                    first = line_id;
+                    if (front > edges.size() / 2) // Compact the rolling buffer.
+                    {
+                        auto shift = edges[front];
+                        utf8.erase(0, shift);
+                        edges.erase(edges.begin(), edges.begin() + front);
+                        for (auto& e : edges) e -= shift;
+                        front = 0;
+                    }
+                }
+                // sieve: Drop the lines starting from the specified line.
+                void pop_back(id_t line_id)
+                {
+                    if (line_id >= next()) return;
+                    if (line_id <= first) clear();
+                    else
+                    {
+                        auto at = front + (line_id - first);
+                        utf8.resize(edges[at]);
+                        edges.resize(at);
+                    }
+                }
+                // sieve: Find the nearest indexed line containing the needle starting from the specified line in the specified direction.
+                auto find(view needle, id_t& line_id, feed direction) const
+                {
+                    auto head = utf8.begin();
+                    auto base = edges.begin() + front;
+                    auto from = base + (line_id - first);
+                    auto iter = utf8.end();
+                    if (direction == feed::fwd)
+                    {
+                        auto seek = std::boyer_moore_horspool_searcher{ needle.begin(), needle.end() };
+                        iter = std::search(head + *from, utf8.end(), seek);
+                    }
+                    else
+                    {
+                        auto tail = from + 1 == edges.end() ? utf8.rbegin() : std::make_reverse_iterator(head + *(from + 1));
+                        auto seek = std::boyer_moore_horspool_searcher{ needle.rbegin(), needle.rend() };
+                        auto rpos = std::search(tail, utf8.rend(), seek);
+                        if (rpos != utf8.rend()) iter = rpos.base() - needle.size();
+                    }
+                    if (iter == utf8.end()) return faux;
+                    auto offset = (size_t)(iter - head);
+                    line_id = first + (id_t)(std::upper_bound(base, edges.end(), offset) - base - 1);
+                    return true;
+                }
+            };
+
             friend auto& operator << (std::ostream& s, scroll_buf& c) // For debug.
             {
                 return s << "{ " << c.batch.max<line::type::leftside>() << ","
@@ -3254,9 +3566,13 @@ namespace netxs::ui
             grip upend; // scroll_buf: Selection first grip inside the bottom margin.
             grip dnend; // scroll_buf: Selection second grip inside the bottom margin.
             part place; // scroll_buf: Selection last active region.
+            depot spare; // scroll_buf: Swapped out lines storage.
+            sieve lexis; // scroll_buf: Text index of the lines far above the viewport.
             si32 shore; // scroll_buf: Left and right scrollbuffer additional indents.
 
             static constexpr auto approx_threshold = si32{ 10000 }; //todo make it configurable
+            static constexpr auto unpacked_lines   = si32{ 1000 }; // Number of lines above the viewport kept unpacked.
+            static constexpr auto unspilled_lines  = si32{ 10000 }; // Number of lines above the viewport kept in memory.
 
             scroll_buf(term& boss)
                 : bufferbase{ boss },
@@ -3457,187 +3773,24 @@ namespace netxs::ui
                 {
                     auto& front = batch.front();
                     auto& under = batch.back();
-                    auto  vtpos = batch.slide - batch.ancdy;
-                    auto delta1 = fresh_slide - vtpos;       // Compare fresh_slide with batch.slide.
-                    auto delta2 = fresh_slide - 0;           // Compare fresh_slide with 0.
-                    auto delta3 = batch.vsize - fresh_slide; // Compare fresh_slide with batch.vsize.
-                    auto range1 = std::abs(delta1);
-                    auto range2 = std::abs(delta2);
-                    auto range3 = std::abs(delta3);
-                    auto lookup = [&]
-                    {
-                        auto idpos = batch.index_by_id(batch.ancid);
-                        auto start = batch.begin() + idpos;
-                        auto found = faux;
-                        if (delta1 < 0) // Look up.
-                        {
-                            auto limit = start - std::min(range1, idpos);
-                            while (start != limit)
-                            {
-                                auto& curln = *--start;
-                                auto height = curln.height(panel.x);
-                                vtpos -= height;
-                                if (vtpos <= fresh_slide)
-                                {
-                                    batch.slide = fresh_slide;
-                                    batch.ancid = curln.index;
-                                    batch.ancdy = fresh_slide - vtpos;
-                                    found = true;
-                                    break;
-                                }
-                            }
-
-                            if (!found)
-                            {
-                                batch.ancid = under.index - (batch.size - 1);
-                                batch.ancdy = 0;
-                                batch.slide = 0;
-                                fresh_slide = 0;
-                                batch.round = faux;
-                                assert(batch.ancid == front.index);
-                            }
-                        }
-                        else if (delta1 > 0) // Look down.
-                        {
-                            auto limit = start + std::min(delta1, batch.size - idpos - 1);
-                            do
-                            {
-                                auto& curln = *start;
-                                auto curpos = vtpos;
-                                auto height = curln.height(panel.x);
-                                vtpos += height;
-                                if (vtpos > fresh_slide)
-                                {
-                                    batch.slide = fresh_slide;
-                                    batch.ancid = curln.index;
-                                    batch.ancdy = fresh_slide - curpos;
-                                    found = true;
-                                    break;
-                                }
-                            }
-                            while (start++ != limit);
-
-                            if (!found)
-                            {
-                                auto& mapln = index.front();
-                                batch.slide = batch.basis;
-                                fresh_slide = batch.basis;
-                                batch.ancid = mapln.index;
-                                batch.ancdy = mapln.start / panel.x;
-                                batch.round = faux;
-                            }
-                        }
-                        else
-                        {
-                            batch.slide = fresh_slide;
-                            batch.ancdy = 0;
-                            found = true;
-                        }
-                    };
-
-                    if (batch.round && range1 < panel.y * 2)
+                    if (fresh_slide <= 0) // Above 0.
                     {
-                        lookup();
-                        auto count1 = (si32)(under.index - batch.ancid);
-                        auto count2 = (si32)(batch.ancid - front.index);
-                        auto min_dy = std::min(count1, count2);
-
-                        if (min_dy < approx_threshold) // Refine position to absolute value.
-                        {
-                            if (count1 < count2)
-                            {
-                                batch.slide = batch.ancdy + batch.vsize;
-                                auto tail = batch.end();
-                                auto head = tail - (count1 + 1);
-                                while (head != tail)
-                                {
-                                    auto& curln = *--tail;
-                                    batch.slide -= curln.height(panel.x);
-                                }
-                            }
-                            else
-                            {
-                                batch.slide = batch.ancdy;
-                                auto head = batch.begin();
-                                auto tail = head + (count2 + 1);
-                                while (head != tail)
-                                {
-                                    auto& curln = *head++;
-                                    batch.slide += curln.height(panel.x);
-                                }
-                            }
-                            batch.round = faux;
-                            fresh_slide = batch.slide;
-                        }
+                        batch.ancid = front.index;
+                        batch.ancdy = fresh_slide;
                     }
-                    else
+                    else if (fresh_slide >= batch.vsize) // Below batch.vsize.
                     {
-                        auto min_dy = std::min({ range1, range2, range3 });
-                        if (min_dy > approx_threshold) // Calc approx.
-                        {
-                            ui64 count1 = std::min(std::max(0, fresh_slide), batch.vsize);
-                            ui64 count2 = batch.vsize;
-                            batch.ancid = front.index + (id_t)netxs::divround(batch.size * count1, count2);
-                            batch.ancdy = 0;
-                            batch.slide = fresh_slide;
-                            batch.round = batch.vsize != batch.size;
-                        }
-                        else if (min_dy == range2 || fresh_slide <= 0) // Calc from the batch top.
-                        {
-                            if (delta2 <= 0) // Above 0.
-                            {
-                                batch.ancid = front.index;
-                                batch.ancdy = delta2;
-                            }
-                            else if (delta2 > 0)
-                            {
-                                auto vpos = 0;
-                                auto head = batch.begin();
-                                auto tail = batch.end();
-                                do
-                                {
-                                    auto& curln = *head;
-                                    auto newpos = vpos + curln.height(panel.x);
-                                    if (newpos > fresh_slide) break;
-                                    else                      vpos = newpos;
-                                }
-                                while (++head != tail);
-                                assert(vpos <= fresh_slide);
-                                batch.ancid = head->index;
-                                batch.ancdy = fresh_slide - vpos;
-                            }
-                            batch.slide = fresh_slide;
-                            batch.round = faux;
-                        }
-                        else if (min_dy == range3 || fresh_slide >= batch.vsize) // Calc from the batch bottom.
-                        {
-                            if (delta3 <= 0) // Below batch.vsize.
-                            {
-                                batch.ancid = under.index;
-                                batch.ancdy = under.height(panel.x) - delta3;
-                            }
-                            else if (delta3 > 0)
-                            {
-                                auto vpos = batch.vsize;
-                                auto head = batch.begin();
-                                auto tail = batch.end();
-                                while (head != tail && vpos > fresh_slide)
-                                {
-                                    auto& curln = *--tail;
-                                    vpos -= curln.height(panel.x);
-                                }
-                                assert(vpos <= fresh_slide);
-                                batch.ancid = tail->index;
-                                batch.ancdy = fresh_slide - vpos;
-                            }
-                            batch.slide = fresh_slide;
-                            batch.round = faux;
-                        }
-                        else if (min_dy == range1) // Calc relative to ancid.
-                        {
-                            lookup();
-                        }
+                        batch.ancid = under.index;
+                        batch.ancdy = under.height(panel.x) + fresh_slide - batch.vsize;
+                    }
+                    else // Look up the height index.
+                    {
+                        auto [at, dy] = batch.vtfind(fresh_slide);
+                        batch.ancid = batch.peek(at).index;
+                        batch.ancdy = dy;
                     }
+                    batch.slide = fresh_slide;
+                    batch.round = faux;
                 }
 
                 return batch.slide == batch.basis;
@@ -3652,39 +3805,9 @@ namespace netxs::ui
                     auto range1 = (si32)(under.index - batch.ancid);
                     auto range2 = (si32)(batch.ancid - front.index);
                     batch.round = faux;
-                    if (range1 < batch.size)
+                    if (range1 >= 0 && range1 < batch.size)
                     {
-                        if (approx_threshold < std::min(range1, range2))
-                        {
-                            auto& mapln = index.front();
-                            auto c1 = (ui64)(si32)(mapln.index - front.index);
-                            auto c2 = (ui64)range2;
-                            auto fresh_slide = (si32)netxs::divround(batch.vsize * c2, c1);
-                            batch.slide = batch.ancdy + fresh_slide;
-                            batch.round = batch.vsize != batch.size;
-                        }
-                        else if (range1 < range2)
-                        {
-                            batch.slide = batch.ancdy + batch.vsize;
-                            auto head = batch.end();
-                            auto tail = head - (range1 + 1);
-                            while (head != tail)
-                            {
-                                auto& curln = *--head;
-                                batch.slide -= curln.height(panel.x);
-                            }
-                        }
-                        else
-                        {
-                            batch.slide = batch.ancdy;
-                            auto head = batch.begin();
-                            auto tail = head + (range2 + 1);
-                            while (head != tail)
-                            {
-                                auto& curln = *head++;
-                                batch.slide += curln.height(panel.x);
-                            }
-                        }
+                        batch.slide = batch.ancdy + batch.vtpos(range2);
                              if (batch.slide > batch.basis) batch.slide = batch.basis;
                         else if (batch.slide <= 0) // Overflow.
                         {
@@ -4178,8 +4301,8 @@ namespace netxs::ui
 
                     auto curit = block.begin();
                     auto width = twod{ size.x, 1 };
-                    auto curid = start == 0 ? batch.front().index
-                                            : batch[start - 1].index + 1;
+                    auto curid = start == 0 ? batch.peek(0).index
+                                            : batch.peek(start - 1).index + 1;
                     auto style = ansi::def_style;
                     style.wrp(wrap::off);
                     while (size.y-- > 0)
@@ -4227,6 +4350,78 @@ namespace netxs::ui
                 index_rebuild();
                 sync_coord();
             }
+            // scroll_buf: Pack the lines that have gone deep into the scrollback. Packed lines are unpacked on access.
+            void compact()
+            {
+                auto packs = owner.defcfg.def_packed;
+                auto swaps = owner.defcfg.def_spills;
+                if (owner.defcfg.def_lookup) sift();
+                if (!packs && !swaps) return;
+                auto limit = batch.size - panel.y - (packs ? unpacked_lines : unspilled_lines);
+                auto depth = batch.size - panel.y - unspilled_lines;
+                if (limit <= 0) return;
+                auto quota = 64; // Pack the newcomers until the first already packed line.
+                auto i = limit;
+                while (quota-- && i-- > 0)
+                {
+                    auto& curln = batch.peek(i);
+                    if (curln.frost.size() || curln.paged.page) break;
+                    curln.freeze();
+                    if (swaps && i < depth) curln.spill(spare);
+                }
+                if (swaps && packs)
+                {
+                    quota = 64; // Swap out the packed lines until the first already swapped out line.
+                    i = depth;
+                    while (quota-- && i-- > 0)
+                    {
+                        auto& curln = batch.peek(i);
+                        if (curln.paged.page) break;
+                        curln.freeze();
+                        curln.spill(spare);
+                    }
+                }
+                quota = 16; // Repack the lines unpacked by random access.
+                while (quota--)
+                {
+                    if (batch.sweep >= limit) batch.sweep = 0;
+                    auto& curln = batch.peek(batch.sweep);
+                    curln.freeze();
+                    if (swaps && batch.sweep < depth) curln.spill(spare);
+                    batch.sweep++;
+                }
+            }
+            // scroll_buf: Drop the text index entries of the evicted lines and of the lines that may have changed since the last sync. Return the number of lines allowed to be indexed.
+            si32 prune()
+            {
+                auto taint = std::exchange(batch.taint, si32max);
+                auto limit = std::min(taint, batch.size - panel.y - unpacked_lines);
+                auto front_id = batch.peek(0).index;
+                if (limit <= 0 || !lexis.holds(front_id)) lexis.reset(front_id);
+                else                                      lexis.pop_front(front_id);
+                if (limit > 0) lexis.pop_back(front_id + (id_t)limit);
+                return limit;
+            }
+            // scroll_buf: Sync the text index with the lines far above the viewport. The lines closer to the viewport may still change and are searched as is.
+            void sift()
+            {
+                auto limit = prune();
+                if (limit <= 0) return;
+                auto front_id = batch.peek(0).index;
+                auto stop_id = front_id + (id_t)limit;
+                auto quota = 4096; // Index the backlog gradually.
+                while (quota-- && lexis.next() != stop_id)
+                {
+                    auto& curln = batch.peek(lexis.next() - front_id);
+                    if (curln.frost.size() || curln.paged.page) // Keep the packed lines packed.
+                    {
+                        auto temp = curln;
+                        temp.thaw();
+                        lexis.push(temp);
+                    }
+                    else lexis.push(curln);
+                }
+            }
             // scroll_buf: Push empty lines to the scrollback bottom.
             void add_lines(si32 amount)
             {
@@ -4270,7 +4465,7 @@ namespace netxs::ui
                 return x;
             }
             // scroll_buf: .
-            auto screen_to_offset(line& curln, twod coor)
+            auto screen_to_offset(line const& curln, twod coor)
             {
                 auto length = curln.length();
                 auto adjust = curln.style.jet();
@@ -4290,7 +4485,7 @@ namespace netxs::ui
                 return coor.x;
             }
             // scroll_buf: .
-            auto offset_to_screen(line& curln, si32 offset)
+            auto offset_to_screen(line const& curln, si32 offset)
             {
                 auto size = curln.length();
                 auto last = size ? size - 1 : 0;
@@ -5305,6 +5500,7 @@ namespace netxs::ui
                     auto after = batch.index_by_id(curid);
                     auto tmpln = std::move(batch[after]);
                     auto curit = batch.ring::insert(after + 1, tmpln.index, tmpln.style, parser::brush);
+                    batch.forget();
                     auto endit = batch.end();
 
                     auto& newln = *curit;
@@ -5488,7 +5684,7 @@ namespace netxs::ui
             // scroll_buf: Calc grip position by coor.
             auto selection_coor_to_grip(twod coor, grip::type role = grip::base)
             {
-                auto link = batch.front().index;
+                auto link = batch.peek(0).index;
                 if (coor.y < 0)
                 {
                     return grip{ .link = link,
@@ -5533,7 +5729,7 @@ namespace netxs::ui
                 auto coor2 = dnmid.coor;
                 auto start = batch.begin() + i_cur;
                 auto limit = batch.end();
-                auto topid = batch.front().index;
+                auto topid = batch.peek(0).index;
                 auto endid = batch.back().index;
                 auto vtpos = batch.slide - batch.ancdy + y_top;
                 auto mxpos = batch.slide + panel.y;
@@ -6098,7 +6294,7 @@ namespace netxs::ui
                             auto head = batch.begin();
                             auto tail = batch.end();
                             auto iter = curit;
-                            upmid.link = batch.front().index;
+                            upmid.link = batch.peek(0).index;
                             while (head != iter)
                             {
                                 auto& curln = *--iter;
@@ -6736,6 +6932,10 @@ namespace netxs::ui
 
                 auto delta = dot_00;
                 auto ahead = direction == feed::fwd;
+                if (owner.defcfg.def_lookup) prune(); // The index is not synced while the scrollback is being viewed.
+                auto needle = owner.defcfg.def_lookup && lexis.size() ? match.utf8() : text{};
+                auto front_id = batch.peek(0).index;
+                auto scratch = line{};
                 auto probe = [&](auto startid, auto coord)
                 {
                     auto& curln = batch.item_by_id(startid);
@@ -6769,9 +6969,27 @@ namespace netxs::ui
                         {
                             auto accum = ahead ? curln.height(panel.x)
                                                : si32{0};
+                            auto curid = (id_t)startid;
                             while (head != tail)
                             {
-                                auto& line = proc(head);
+                                auto nxtid = ahead ? curid + 1 : curid - 1;
+                                if (needle.size() && lexis.holds(nxtid)) // Leap over the indexed lines that don't contain the match.
+                                {
+                                    auto hitid = nxtid;
+                                    if (!lexis.find(needle, hitid, direction))
+                                    {
+                                        if (!ahead && lexis.first == batch.peek(0).index) return faux;
+                                        hitid = ahead ? lexis.next() : lexis.first - 1;
+                                    }
+                                    hitid = std::clamp(hitid, front_id, front_id + (id_t)(batch.size - 1));
+                                    auto a = batch.index_by_id(nxtid);
+                                    auto b = batch.index_by_id(hitid);
+                                    accum += ahead ? batch.vtpos(b) - batch.vtpos(a)
+                                                   : batch.vtpos(a + 1) - batch.vtpos(b + 1);
+                                    head = batch.begin() + (ahead ? b - 1 : b + 1);
+                                }
+                                auto& line = proc(head).thawed(scratch); // Keep the packed lines packed.
+                                curid = line.index;
                                 from = ahead ? 0 : line.length();
                                 if (resx(line))
                                 {
@@ -6786,7 +7004,7 @@ namespace netxs::ui
                         if (ahead)
                         {
                             uirev = faux;
-                            done = find(batch.end() - 1, [](auto& head) -> auto& { return *++head; });
+                            done = find(batch.end() - 1, [](auto& head) -> auto& { return (++head).peek(); });
                             if (!done && sctop)
                             {
                                 from = si32{ 0 };
@@ -6802,7 +7020,7 @@ namespace netxs::ui
                         else
                         {
                             uifwd = faux;
-                            done = find(batch.begin(), [](auto& head) -> auto& { return *--head; });
+                            done = find(batch.begin(), [](auto& head) -> auto& { return (--head).peek(); });
                             if (!done && scend)
                             {
                                 from = upbox.size().x * upbox.size().y;
@@ -6903,6 +7121,29 @@ namespace netxs::ui
                 bufferbase::selection_update(faux);
                 return delta;
             }
+            // scroll_buf: Return the number of matches in the scrollback and margins.
+            si32 selection_tally() override
+            {
+                if (match.empty()) return 0;
+                auto count = bufferbase::selection_tally(upbox)
+                           + bufferbase::selection_tally(dnbox);
+                if (owner.defcfg.def_lookup) prune();
+                auto needle = owner.defcfg.def_lookup && lexis.size() ? match.utf8() : text{};
+                auto front_id = batch.peek(0).index;
+                auto scratch = line{};
+                for (auto i = 0; i < batch.size; i++)
+                {
+                    auto line_id = front_id + (id_t)i;
+                    if (needle.size() && lexis.holds(line_id)) // Leap over the indexed lines that don't contain the match.
+                    {
+                        if (!lexis.find(needle, line_id, feed::fwd)) line_id = lexis.next();
+                        i = (si32)std::min(line_id - front_id, (id_t)batch.size);
+                        if (i == batch.size) break;
+                    }
+                    count += bufferbase::selection_tally(batch.peek(i).thawed(scratch)); // Keep the packed lines packed.
+                }
+                return count;
+            }
             // scroll_buf: Return match navigation state.
             si32 selection_button(twod delta = {}) override
             {
@@ -7424,6 +7665,8 @@ namespace netxs::ui
                                    || (next_basis <= last_slide && last_slide <= last_basis);
                 }
             }
+            if ((defcfg.def_packed || defcfg.def_spills || defcfg.def_lookup) && follow[axis::Y]) normal.compact(); // Don't repack the lines while the scrollback is being viewed.
+            if (unsync) bell::indexer.quartz.wake(); // The changes are applied on the next tick.
         }
         // term: Proceed terminal input.
         template<bool Forced = faux>
@@ -7446,10 +7689,25 @@ namespace netxs::ui
         template<bool Forced = faux>
         void ondata(view data = {}, bufferbase* target_buffer = {})
         {
-            update([&]
+            // Apply the input in slices cut at sequence boundaries, releasing the lock in between
+            // so that a flooding application doesn't freeze the rest of the desktop.
+            static constexpr auto slice = 64 * 1024;
+            while (true)
             {
-                return ondata_direct<Forced>(data, target_buffer);
-            });
+                auto crop = data;
+                if (crop.size() > slice)
+                {
+                    crop = ansi::purify(crop.substr(0, slice));
+                    if (crop.empty()) crop = data; // The sequence is longer than the slice.
+                }
+                update([&]
+                {
+                    return ondata_direct<Forced>(crop, target_buffer);
+                });
+                data.remove_prefix(crop.size());
+                if (data.empty()) break;
+                std::this_thread::yield();
+            }
         }
         // term: Reset to defaults.
         void setdef()
@@ -8313,6 +8571,11 @@ namespace netxs::ui
                                                             gear.set_handled();
                                                         });
                                                     }},
+                { methods::CountMatches,            [&]
+                                                    {
+                                                        auto count = target->selection_tally();
+                                                        luafx.set_return(count);
+                                                    }},
                 { methods::ScrollViewportByPage,    [&]
                                                     {
                                                         luafx.run_with_gear([&](auto& gear)
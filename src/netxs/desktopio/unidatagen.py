@@ -404,12 +404,47 @@ namespace netxs::unidata
         }}
         return data;
     }}
+    // unidata: Three-stage lookup table rebuilt from the packed two-stage one (~24KB instead of ~52KB).
+    struct lookup
+    {{
+        std::vector<ui16> pages; // lookup: Span offset by cp >> 10.
+        std::vector<ui16> spans; // lookup: Leaf offset by span offset + (cp >> 5) & 0x1F.
+        std::vector<byte> props; // lookup: ucspec index by leaf offset + cp & 0x1F.
+
+        lookup()
+        {{
+            auto offset = unpack<byte>(base::offset_pack, base::offset_size);
+            auto blocks = unpack<ui16>(base::blocks_pack, base::blocks_size);
+            auto dedup = [](auto& data, auto head, auto tail) // Return the offset of the same chunk, append if not found.
+            {{
+                auto size = (sz_t)(tail - head);
+                for (auto i = sz_t{{}}; i < data.size(); i += size)
+                {{
+                    if (std::equal(head, tail, data.begin() + i)) return (ui16)i;
+                }}
+                data.insert(data.end(), head, tail);
+                return (ui16)(data.size() - size);
+            }};
+            auto known = std::vector<si32>(offset.size() / 32, -1); // Leaf offsets of the already deduplicated chunks of the offset table.
+            auto chunk = std::vector<ui16>(32);
+            for (auto cp = 0u; cp <= 0x10FFFF; cp += 1024)
+            {{
+                for (auto i = 0u; i < 32; i++)
+                {{
+                    auto from = blocks[(cp >> 8) + (i >> 3)] + (i & 7) * 32;
+                    auto& leaf = known[from / 32];
+                    if (leaf == -1) leaf = dedup(props, offset.begin() + from, offset.begin() + from + 32);
+                    chunk[i] = (ui16)leaf;
+                }}
+                pages.push_back(dedup(spans, chunk.begin(), chunk.end()));
+            }}
+        }}
+    }};
     unidata const& select(ui32 cp)
     {{
-        static auto offset = unpack<byte>(base::offset_pack, base::offset_size);
-        static auto blocks = unpack<ui16>(base::blocks_pack, base::blocks_size);
+        static auto const table = lookup{{}};
         return cp > 0x10FFFF ? base::ucspec[0]
-                             : base::ucspec[offset[blocks[cp >> 8] + (cp & 0xFF)]];
+                             : base::ucspec[table.props[table.spans[table.pages[cp >> 10] + ((cp >> 5) & 0x1F)] + (cp & 0x1F)]];
     }}
     auto script(ui32 cp)
     {{
@@ -6,6 +6,13 @@
 #include "quartz.hpp"
 #include "unidata.hpp"
 
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define NETXS_SSE2
+#endif
+
 namespace netxs
 {
     using view = std::string_view;
@@ -696,6 +703,40 @@ namespace netxs::utf
             while (code);
         }
     }
+    // utf: Return the length of the leading run of printable ASCII chars [0x20 - 0x7E].
+    auto plain(view utf8)
+    {
+        auto head = utf8.data();
+        auto iter = head;
+        auto tail = head + utf8.size();
+        // Signed bytes shifted by 0x60 fall below -33 only for the [0x20 - 0x7E] range.
+        #if defined(__AVX2__)
+        auto bias = _mm256_set1_epi8(0x60);
+        auto edge = _mm256_set1_epi8(-33);
+        while (tail - iter >= 32)
+        {
+            auto v = _mm256_add_epi8(_mm256_loadu_si256((__m256i const*)iter), bias);
+            auto m = (ui32)_mm256_movemask_epi8(_mm256_cmpgt_epi8(edge, v));
+            if (m != ~0u) return (size_t)(iter - head) + std::countr_one(m);
+            iter += 32;
+        }
+        #elif defined(NETXS_SSE2)
+        auto bias = _mm_set1_epi8(0x60);
+        auto edge = _mm_set1_epi8(-33);
+        while (tail - iter >= 16)
+        {
+            auto v = _mm_add_epi8(_mm_loadu_si128((__m128i const*)iter), bias);
+            auto m = (ui32)_mm_movemask_epi8(_mm_cmplt_epi8(v, edge));
+            if (m != 0xFFFFu) return (size_t)(iter - head) + std::countr_one(m);
+            iter += 16;
+        }
+        #endif
+        while (iter != tail && (byte)*iter >= 0x20 && (byte)*iter < 0x7f)
+        {
+            ++iter;
+        }
+        return (size_t)(iter - head);
+    }
     // utf: Break the text into the grapheme clusters.
     //      Forward the result using the callable "serve" and "yield".
     //      serve: Processes controls and returns the rest of the utf8.
@@ -774,10 +815,8 @@ namespace netxs::utf
                     {
                         auto rest = code.rest();
                         auto head = rest.begin();
-                        auto iter = head;
                         auto tail = rest.end();
-                        while (++iter != tail && is_plain(*iter))
-                        { }
+                        auto iter = head + utf::plain(rest);
                         auto plain = view{ head, iter };
                         if (iter == tail)
                         {
@@ -296,14 +296,12 @@ namespace netxs::xml
         {
             text utf8; // literal: Content data.
             si32 kind; // literal: Content type.
-            si32 busy; // literal: Reference loop detector mark.
 
             literal(literal&&) = default;
             literal(literal const&) = default;
             literal(si32 kind = type::na, view utf8 = {})
                 : utf8{ utf8 },
-                  kind{ kind },
-                  busy{      }
+                  kind{ kind }
             { }
         };
 
@@ -1285,6 +1283,11 @@ namespace netxs::xml
         sptr root_ptr;
 
         document(document&&) = default;
+        document(document const& other)
+            : page{ other.page.file }
+        {
+            clone(other);
+        }
         document(view utf8 = {}, view file = {})
             : page{ file }
         {
@@ -1297,6 +1300,66 @@ namespace netxs::xml
             page.init(file);
             parser{ root_ptr, page, utf8 };
         }
+        // document: Copy the fragment list and the element tree of the other document without reparsing.
+        void clone(document const& other)
+        {
+            auto& dst_list = page.frag_list;
+            auto& src_list = other.page.frag_list;
+            auto remap = std::unordered_map<literal const*, f_it>{};
+            dst_list.clear();
+            for (auto& frag : src_list)
+            {
+                remap[&frag] = dst_list.insert(dst_list.end(), frag);
+            }
+            page.fail = other.page.fail;
+            page.file = other.page.file;
+            auto cloned = std::unordered_map<elem const*, sptr>{};
+            auto relink = [&](f_it iter)
+            {
+                if (iter == src_list.end()) return dst_list.end();
+                auto mapped = remap.find(&*iter);
+                return mapped != remap.end() ? mapped->second : dst_list.end();
+            };
+            auto duplicate = [&](auto& self, sptr const& src_ptr, sptr const& parent_ptr) -> sptr
+            {
+                if (!src_ptr) return src_ptr;
+                auto& dst_ptr = cloned[src_ptr.get()];
+                if (dst_ptr) return dst_ptr;
+                auto& src = *src_ptr;
+                dst_ptr = ptr::shared<elem>(dst_list);
+                auto item_ptr = dst_ptr; // The map reference is not stable across recursion.
+                auto& dst = *item_ptr;
+                dst.from = relink(src.from);
+                dst.upto = relink(src.upto);
+                dst.name = relink(src.name);
+                dst.insA = relink(src.insA);
+                dst.insB = relink(src.insB);
+                dst.value_segments.reserve(src.value_segments.size());
+                for (auto& [vbeg, vend] : src.value_segments)
+                {
+                    dst.value_segments.emplace_back(relink(vbeg), relink(vend));
+                }
+                dst.body.reserve(src.body.size());
+                for (auto& value_placeholder : src.body)
+                {
+                    dst.body.push_back(relink(value_placeholder));
+                }
+                dst.base = src.base;
+                dst.mode = src.mode;
+                dst.parent_wptr = parent_ptr;
+                for (auto& [sub_name, sub_list] : src.hive)
+                {
+                    auto& dst_sub_list = dst.hive[sub_name];
+                    dst_sub_list.reserve(sub_list.size());
+                    for (auto& sub_ptr : sub_list)
+                    {
+                        dst_sub_list.push_back(self(self, sub_ptr, item_ptr));
+                    }
+                }
+                return item_ptr;
+            };
+            root_ptr = duplicate(duplicate, other.root_ptr, sptr{});
+        }
         template<bool WithTemplate = faux>
         auto take_direct_ptr_list(sptr node_ptr, qiew path_str, vect& crop)
         {
@@ -1473,24 +1536,30 @@ namespace netxs::xml
         using sptr = xml::document::sptr;
         using list = std::list<xml::document::sptr>;
 
-        xml::document document; // settings: XML document.
+        netxs::sptr<xml::document> document; // settings: XML document (shared between copies until modified).
         vect tmpbuff; // settings: Temp buffer.
         list context; // settings: Current working context stack (reference context).
+        std::vector<document::literal const*> trail; // settings: Reference loop detector.
 
-        settings() = default;
+        settings()
+            : document{ ptr::shared<xml::document>() }
+        { }
         settings(view utf8_xml)
-            : document{ utf8_xml }
+            : document{ ptr::shared<xml::document>(utf8_xml) }
         { }
         settings(settings const& config)
-            : document{ config.document.page.utf8() }
+            : document{ config.document }
         { }
         settings(xml::document&& document)
-            : document{ std::move(document) }
+            : document{ ptr::shared<xml::document>(std::move(document)) }
+        { }
+        settings(netxs::sptr<xml::document> document_ptr)
+            : document{ document_ptr }
         { }
 
         sptr get_context()
         {
-            auto context_path = context.size() ? context.back() : document.root_ptr;
+            auto context_path = context.size() ? context.back() : document->root_ptr;
             return context_path;
         }
         // settings: Push document context by name.
@@ -1532,12 +1601,12 @@ namespace netxs::xml
         }
         friend auto& operator << (std::ostream& s, settings const& p)
         {
-            return s << p.document.page.show();
+            return s << p.document->page.show();
         }
         // settings: Lookup document context for item_ptr by its reference name path.
         void _find_namepath(view reference_namepath, sptr& item_ptr)
         {
-            auto item_ptr_list = document.take_ptr_list<true>(reference_namepath);
+            auto item_ptr_list = document->take_ptr_list<true>(reference_namepath);
             if (item_ptr_list.size())
             {
                 item_ptr = item_ptr_list.back();
@@ -1583,9 +1652,10 @@ namespace netxs::xml
                  || kind == document::type::raw_reference)
                 {
                     auto& reference_name = value_placeholder->utf8;
-                    if (!value_placeholder->busy)
+                    auto placeholder = &*value_placeholder;
+                    if (std::ranges::find(trail, placeholder) == trail.end())
                     {
-                        value_placeholder->busy = 1;
+                        trail.push_back(placeholder);
                         if (auto base_item_ptr = settings::_find_name(reference_name))
                         {
                             settings::_take_value(base_item_ptr, value);
@@ -1594,7 +1664,7 @@ namespace netxs::xml
                         {
                             log("%%%red%Reference name '%ref%' not found%nil%", prompt::xml, ansi::fgc(redlt), reference_name, ansi::nil());
                         }
-                        value_placeholder->busy = 0;
+                        trail.pop_back();
                     }
                     else
                     {
@@ -1624,19 +1694,20 @@ namespace netxs::xml
                  || kind == document::type::raw_reference)
                 {
                     auto& reference_name = value_placeholder->utf8;
-                    if (!value_placeholder->busy) // Silently ignore reference loops.
+                    auto placeholder = &*value_placeholder;
+                    if (std::ranges::find(trail, placeholder) == trail.end()) // Silently ignore reference loops.
                     {
-                        value_placeholder->busy = 1;
+                        trail.push_back(placeholder);
                         if (auto base_ptr = settings::_find_name(reference_name)) // Lookup outside.
                         {
                             settings::_take_ptr_list_of(base_ptr, attribute, item_ptr_list);
                         }
-                        value_placeholder->busy = 0;
+                        trail.pop_back();
                     }
                 }
             }
             // Take native attribute list.
-            document.take_direct_ptr_list(subsection_ptr, attribute, item_ptr_list);
+            document->take_direct_ptr_list(subsection_ptr, attribute, item_ptr_list);
         }
         auto take_ptr_list_of(sptr subsection_ptr, view attribute)
         {
@@ -1720,7 +1791,7 @@ namespace netxs::xml
             {
                 auto ctx = settings::push_context(context_ptr);
                 auto item_ptr_list = vect{};
-                document.take_direct_ptr_list(context_ptr, frompath, item_ptr_list);
+                document->take_direct_ptr_list(context_ptr, frompath, item_ptr_list);
                 if (auto item_ptr = item_ptr_list.size() ? item_ptr_list.back() : sptr{})
                 {
                     auto crop = settings::take_value(item_ptr);
@@ -1822,20 +1893,24 @@ namespace netxs::xml
         }
         auto utf8()
         {
-            return document.page.utf8();
+            return document->page.utf8();
         }
         template<bool Print = faux>
         auto fuse(view utf8_xml, view filepath = {})
         {
             if (utf8_xml.empty()) return;
-            if (filepath.size()) document.page.file = filepath;
             context.clear();
+            if (document.use_count() > 1) // Copy on write.
+            {
+                document = ptr::shared<xml::document>(std::as_const(*document));
+            }
+            if (filepath.size()) document->page.file = filepath;
             auto tmp_config = xml::document{ utf8_xml, filepath };
             if constexpr (Print)
             {
                 log("%%Settings from %file%:\n%config%", prompt::xml, filepath.empty() ? "memory"sv : filepath, tmp_config.page.show());
             }
-            document.combine_item(tmp_config.root_ptr);
+            document->combine_item(tmp_config.root_ptr);
         }
     };
     namespace options
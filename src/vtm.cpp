@@ -462,7 +462,7 @@ int main(int argc, char* argv[])
         auto config_lock = ui::tui_domain().unique_lock(); // Sync multithreaded access to config.
         auto desktop = app::vtm::hall::ctor(server, config);
         desktop->autorun();
-        auto config_utf8 = config.settings::utf8();
+        auto config_dom = config.document; // Parsed once and shared by all sessions until modified.
         config_lock.unlock();
 
         log("%%Session started"
@@ -521,7 +521,7 @@ int main(int argc, char* argv[])
         {
             if (user->auth(userid.second))
             {
-                desktop->run([&, user, config_utf8](auto session_id)
+                desktop->run([&, user, config_dom](auto session_id)
                 {
                     auto userinit = directvt::binary::init{};
                     if (auto packet = userinit.recv(user))
@@ -529,7 +529,7 @@ int main(int argc, char* argv[])
                         auto id = utf::concat(*user);
                         if constexpr (debugmode) log("%%Client connected %id%", prompt::user, id);
                         auto usrcfg = eccc{ .env = packet.env, .cwd = packet.cwd, .cmd = packet.cmd, .win = packet.win };
-                        auto config = settings{ config_utf8 };
+                        auto config = settings{ config_dom };
                         config.settings::fuse(packet.cfg);
                         os::ipc::users++;
                         desktop->invite(user, packet.user, packet.mode, usrcfg, config, session_id);
@@ -594,6 +594,19 @@ namespace netxs::app::vtm
                 });
             }
 
+            // window: Return the window area including the decorations drawn outside of it (header/footer, sizer border and shadow).
+            auto footprint()
+            {
+                auto& title = base::plugin<pro::title>();
+                auto outer = base::signal(tier::request, e2::config::plugins::sizer::outer);
+                return base::region + outer + dent{ 1, 1, 1 + title.head_size.y, 1 + title.foot_size.y };
+            }
+            // window: Return true if the window bitmap is up to date and hides everything under the window region.
+            auto opaque()
+            {
+                return !base::hidden && base::plugin<pro::cache>().opaque();
+            }
+
         protected:
             // window: .
             void deform(rect& new_area) override
@@ -627,6 +640,7 @@ namespace netxs::app::vtm
                 base::plugin<pro::sizer>();
                 base::plugin<pro::frame>();
                 base::plugin<pro::light>();
+                base::plugin<pro::cache>(true, faux); // Render the window once per frame for all users (the applet applies the transparency on its own).
                 base::plugin<pro::focus>();
                 base::plugin<pro::keybd>();
                 base::limits(dot_11);
@@ -1174,6 +1188,18 @@ namespace netxs::app::vtm
                                             base::cleanup(show_details);
                                             luafx.set_return();
                                         }},
+                { "Telemetry",          [&]
+                                        {
+                                            auto reset = luafx.get_args_or(1, faux);
+                                            auto lines = text{};
+                                            for (auto& [user_ptr, uname] : users) // One JSON line per gate.
+                                            {
+                                                auto& usergate = *(std::static_pointer_cast<gate>(user_ptr));
+                                                lines += usergate.telemetry(reset) + '\n';
+                                            }
+                                            if (lines.size()) lines.pop_back();
+                                            luafx.set_return(lines);
+                                        }},
                 { "EventList",          [&]
                                             {
                                                 log("Registered events:");
@@ -1253,7 +1279,7 @@ namespace netxs::app::vtm
                                                 });
                                                 log("%%Run %%", prompt::host, ansi::hi(utf::debase437(utf8_xml)));
                                                 auto appconf = settings{ utf8_xml };
-                                                auto item_ptr = appconf.document.root_ptr;
+                                                auto item_ptr = appconf.document->root_ptr;
                                                 auto menuid = config.settings::take_value_from(item_ptr, attr::id, ""s);
                                                 auto taskbar_context = config.settings::push_context(path::taskbar);
                                                 if (menu_list.contains(menuid))
@@ -1615,6 +1641,7 @@ namespace netxs::app::vtm
                 }
             };
             auto& layers = base::field<std::array<std::vector<sptr>, 3>>();
+            auto& shroud = base::field<std::vector<byte>>(); // Coverage mask of the gate viewport.
             LISTEN(tier::release, e2::render::any, parent_canvas)
             {
                 auto clip = parent_canvas.clip();         // Draw world without clipping. Wolrd has no size.
@@ -1653,11 +1680,50 @@ namespace netxs::app::vtm
                             layers[i].push_back(item_ptr);
                         }
                     }
-                    for (auto& layer : layers)
+                    auto view = parent_canvas.clip();
+                    auto mask = [&](rect area)
+                    {
+                        area = area.trim(view);
+                        area.coor -= view.coor;
+                        return area;
+                    };
+                    auto covered = [&](rect area)
+                    {
+                        for (auto y = area.coor.y; y < area.coor.y + area.size.y; y++)
+                        {
+                            auto head = shroud.begin() + y * view.size.x + area.coor.x;
+                            auto tail = head + area.size.x;
+                            if (std::find(head, tail, 0) != tail) return faux;
+                        }
+                        return true;
+                    };
+                    shroud.assign((size_t)view.size.x * view.size.y, 0);
+                    for (auto layer = layers.rbegin(); layer != layers.rend(); ++layer) // Walk the windows front to back and drop the ones fully covered by the opaque windows above.
+                    {
+                        for (auto iter = layer->rbegin(); iter != layer->rend(); ++iter)
+                        {
+                            auto& window = *std::static_pointer_cast<window_t>(*iter);
+                            if (window.base::hidden) continue;
+                            if (covered(mask(window.footprint())))
+                            {
+                                iter->reset();
+                            }
+                            else if (window.opaque())
+                            {
+                                auto area = mask(window.base::region);
+                                for (auto y = area.coor.y; y < area.coor.y + area.size.y; y++)
+                                {
+                                    auto head = shroud.begin() + y * view.size.x + area.coor.x;
+                                    std::fill(head, head + area.size.x, 1);
+                                }
+                            }
+                        }
+                    }
+                    for (auto& layer : layers) // Compose the rest back to front.
                     {
                         for (auto& item_ptr : layer)
                         {
-                            item_ptr->render<true>(parent_canvas);
+                            if (item_ptr) item_ptr->render<true>(parent_canvas);
                         }
                         layer.clear();
                     }